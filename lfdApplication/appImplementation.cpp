@@ -220,68 +220,67 @@ void hyptrain()
 {
     init();
 
-    ifstream inFile;
-    inFile.open("applicationData/trainingdata.txt");
-    
-    int _da, _dx, _dy, _dz, _g, _dfx, _dfy, _dfz, _dfa, _dfg;
-    string line;
+    //every file of the corpus parsed in parallel, identical demonstrations once, in a fixed order
+    TrainingCorpus demos;
+    demos.addFiles(TRAININGCORPUS);
+    demos.setOrder(CORPUSORDER, CORPUSSEED);
+
+    //files that can't be read are reported, training goes on with the others
+    int kept = demos.load(CORPUSTHREADS);
+
+    for (int f = 0; f < demos.files(); f++)
+    {
+        if (demos.fileDemos(f) < 0)
+            printf("Error opening file %s!\n", demos.path(f).c_str());
+    }
+
+    for (int i = 0; i < demos.unmatched(); i++)
+    {
+        printf("No file matches %s!\n", demos.unmatchedPattern(i).c_str());
+    }
+
+    if (kept < 0)
+        return;
 
-    bool actionread = false;
+    for (int i = 0; i < demos.size(); i++)
+    {
+        train(demos.demo(i), 0, demos.demo(i).length() - 1);
+    }
+}
 
-    Event_t *events = new Event_t();
+//the event of a recorded action (1) or observation (2)
+EventUnion recordedEvent(int eventtype, int x, int y, int z, int angle, int grasp)
+{
     EventUnion e;
 
-    while (getline(inFile, line))
+    if (eventtype == 1)
     {
-        if (line != "end")
-        {
-            if(line == "finish")
-            {
-                train(events, 0, getEventSeqLen(events) - 1);
-                events = new Event_t();
-
-                continue;
-            }
-
-            if (!actionread)
-            {            
-                //read action
-                
-                sscanf(line.c_str(), " %d %d %d %d %d", &_dx, &_dy, &_dz, &_da, &_g);                                                
-
-                actionread = true;
-
-                e.action.deltaangle = _da;
-                e.action.deltaX = _dx;
-                e.action.deltaY = _dy;
-                e.action.deltaZ = _dz;
-                e.action.grasp = _g;
-
-                push(events, e, 1);
-
-            }
-            else
-            {
-                //read obseration
-
-                actionread = false;
-                sscanf(line.c_str(), " %d %d %d %d %d", &_dfx, &_dfy, &_dfz, &_dfa, &_dfg); 
-                
-                e.observation.diffZ = _dfz;
-                e.observation.diffY = _dfy;
-                e.observation.diffX =  _dfz;
-                e.observation.diffangle = _dfa;
-                e.observation.grasp = _dfg;
-
-                push(events, e, 2);
-
-            }
-        }
-        else
-            break;
+        e.action.deltaX = x;
+        e.action.deltaY = y;
+        e.action.deltaZ = z;
+        e.action.deltaangle = angle;
+        e.action.grasp = grasp;
+    }
+    else
+    {
+        e.observation.diffX = x;
+        e.observation.diffY = y;
+        e.observation.diffZ = z;
+        e.observation.diffangle = angle;
+        e.observation.grasp = grasp;
     }
 
-    delete events;
+    return e;
+}
 
+//appends one recorded event to the demonstration log, without waiting for the disk
+void recordEvent(DemoLogWriter &log, int eventtype, int x, int y, int z, int angle, int grasp)
+{
+    log.event(recordedEvent(eventtype, x, y, z, angle, grasp), eventtype);
 }
 
+//online training: hands one recorded action (1) or observation (2) to the session
+void observeEvent(PslSession &session, int eventtype, int x, int y, int z, int angle, int grasp)
+{
+    session.observe(recordedEvent(eventtype, x, y, z, angle, grasp), eventtype);
+}
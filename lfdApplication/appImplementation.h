@@ -5,9 +5,28 @@
 #define TRAIN 1
 #define CALIBRATE 0
 #define DEMO 1
+#define SNAPSHOT 0 //save the trained library to applicationData/hypotheses.psl, without DEMO start from it
+#define ONLINE 0 //train while demonstrating instead of after (requires DEMO)
+#define BINARYLOG 0 //record demonstrations to a binary log instead of trainingdata.txt (psllog converts between them)
+#define PSLCONFIG "applicationControl/pslConfig.txt" //PSL parameters, see predictiveSeqLearning/pslConfig.h
 #define CAM_IDX1 0
 #define CAM_IDX2 2
 
+#if BINARYLOG
+#define TRAININGDATA "applicationData/demos.log"
+#define TRAININGDATA_FORMAT DEMOLOG_BINARY
+#else
+#define TRAININGDATA "applicationData/trainingdata.txt"
+#define TRAININGDATA_FORMAT DEMOLOG_TEXT
+#endif
+
+//demonstrations hyptrain learns from: space separated files and glob patterns, e.g.
+//TRAININGDATA " applicationData/trainingdata2.txt applicationData/archive/*.log"
+#define TRAININGCORPUS TRAININGDATA
+#define CORPUSORDER CORPUS_FILES //CORPUS_FILES, CORPUS_INTERLEAVE or CORPUS_SHUFFLE
+#define CORPUSSEED 0             //seed of CORPUS_SHUFFLE
+#define CORPUSTHREADS 4          //files parsed at once
+
 using namespace std;
 using namespace cv;
 
@@ -30,4 +49,10 @@ void sig(int s);
 
 void hyptrain();
 
+EventUnion recordedEvent(int eventtype, int x, int y, int z, int angle, int grasp);
+
+void recordEvent(DemoLogWriter &log, int eventtype, int x, int y, int z, int angle, int grasp);
+
+void observeEvent(PslSession &session, int eventtype, int x, int y, int z, int angle, int grasp);
+
 void loadCameraModel(float cameraModel[][4]);
@@ -18,6 +18,9 @@ int main()
 
     readRobotConfigurationData("applicationControl/robotConfig.txt");
 
+    if (loadPslConfig(PSLCONFIG) < 0)
+        printf("Error reading PSL configuration file %s, using the defaults\n", PSLCONFIG);
+
     float x = 0;
     float y = 120;
     float z = 200;
@@ -105,14 +108,21 @@ int main()
 
     printf("\n %s \n", "Commence demonstration");
 
-    FILE *training_file = fopen("applicationData/trainingdata.txt", "a");
+    //the control loop only queues events, a writer thread of the log does the file writes
+    DemoLogWriter training_file;
 
-    if (training_file == NULL)
+    if (!training_file.open(TRAININGDATA, TRAININGDATA_FORMAT))
     {
         printf("Error opening file!\n");
         exit(1);
     }
 
+#if ONLINE
+    //the earlier demonstrations in the file, then every new event as it is recorded
+    hyptrain();
+    PslSession session(getDefaultModel());
+#endif
+
     spnav_event sev;
     signal(SIGINT, sig);
 
@@ -208,7 +218,7 @@ int main()
                         last_action_theta = index == 4 ? poseDelta[4] < 0.0 ? (delta * -1): delta : 0;
                         last_action_grasp = graspVal;
 
-                        fprintf(training_file, " %d %d %d %d %d\n", last_action_x, last_action_y, last_action_z, last_action_theta, last_action_grasp);
+                        recordEvent(training_file, 1, last_action_x, last_action_y, last_action_z, last_action_theta, last_action_grasp);
 
                         //endeffector and object differential pose
 
@@ -218,7 +228,12 @@ int main()
                         last_obs_theta = (int)(objectpose[3] += 0.5);
                         last_obs_grasp = graspVal;
 
-                        fprintf(training_file, " %d %d %d %d %d\n", last_obs_x, last_obs_y, last_obs_z, last_obs_theta, last_obs_grasp);
+                        recordEvent(training_file, 2, last_obs_x, last_obs_y, last_obs_z, last_obs_theta, last_obs_grasp);
+
+#if ONLINE
+                        observeEvent(session, 1, last_action_x, last_action_y, last_action_z, last_action_theta, last_action_grasp);
+                        observeEvent(session, 2, last_obs_x, last_obs_y, last_obs_z, last_obs_theta, last_obs_grasp);
+#endif
                     }
                 }
             }
@@ -232,10 +247,21 @@ int main()
                 graspVal = abs(graspVal - GRIPPER_OPEN);
                 grasp(graspVal);
 
+                //the toggle is an action of its own: no motion, only the new grasp. repeating the deltas
+                //of the last motion would record that motion a second time
+                last_action_x = 0;
+                last_action_y = 0;
+                last_action_z = 0;
+                last_action_theta = 0;
                 last_action_grasp = graspVal;
-                fprintf(training_file, " %d %d %d %d %d\n", last_action_x, last_action_y, last_action_z, last_action_theta, last_action_grasp);
+                recordEvent(training_file, 1, last_action_x, last_action_y, last_action_z, last_action_theta, last_action_grasp);
                 last_obs_grasp = graspVal;
-                fprintf(training_file, " %d %d %d %d %d\n", last_obs_x, last_obs_y, last_obs_z, last_obs_theta, last_obs_grasp);
+                recordEvent(training_file, 2, last_obs_x, last_obs_y, last_obs_z, last_obs_theta, last_obs_grasp);
+
+#if ONLINE
+                observeEvent(session, 1, last_action_x, last_action_y, last_action_z, last_action_theta, last_action_grasp);
+                observeEvent(session, 2, last_obs_x, last_obs_y, last_obs_z, last_obs_theta, last_obs_grasp);
+#endif
             }
 
             else if (sev.button.bnum == 1)
@@ -258,7 +284,10 @@ int main()
                     graspVal = 0;
                     grasp(graspVal);
 
-                    fclose(training_file);
+                    training_file.close();
+
+                    if (training_file.dropped() > 0)
+                        printf("\n %ld events were not logged \n", training_file.dropped());
                     break;
                 }
                 else
@@ -266,7 +295,10 @@ int main()
                     if (sev.button.press)
                     {
 
-                        fprintf(training_file, "%s\n", "finish");
+                        training_file.finish();
+#if ONLINE
+                        session.finish();
+#endif
                         printf("\n %s \n", "End of current Demonstration");
 
                         gotoPose(0, 120, 200, pitch, -90);
@@ -310,9 +342,29 @@ int main()
 #endif
 
     bool trained = false;
+
+#if SNAPSHOT && !DEMO
+    //no new demonstrations: the library saved by the last run is loaded from its snapshot instead of retrained.
+    //the snapshot is only a faster load format, the model is queried as after training
+    PslSnapshot snapshot;
+
+    if (snapshot.open("applicationData/hypotheses.psl"))
+    {
+        clearHypotheses();
+        snapshot.copyTo(getDefaultModel());
+        snapshot.close();
+
+        printf("\n %s \n", "Hypotheses loaded");
+
+        trained = true;
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+    }
+#endif
+
     //train PSL using demonstration data
 
-    while (spnav_wait_event(&sev))
+    while (!trained && spnav_wait_event(&sev))
     {
         if (sev.type == SPNAV_EVENT_BUTTON)
         {
@@ -327,10 +379,17 @@ int main()
                 {
                     printf("\n %s \n", "Start training");
 
-                    hyptrain();
+#if !(ONLINE && DEMO)
+                    hyptrain(); //with ONLINE the model was trained during the demonstrations
+#endif
 
                     printf("\n %s \n", "Training done");
 
+#if SNAPSHOT
+                    if (writeSnapshot(getDefaultModel(), "applicationData/hypotheses.psl") != 0)
+                        printf("\n %s \n", "Error writing the hypotheses snapshot");
+#endif
+
                     trained = true;
 
                     clock_gettime(CLOCK_MONOTONIC_RAW, &start);
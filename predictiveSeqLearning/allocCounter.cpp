@@ -0,0 +1,57 @@
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+#include "allocCounter.h"
+
+using namespace std;
+
+static atomic<long> allocs(0);
+static atomic<long> bytes(0);
+
+AllocCount allocCount()
+{
+    AllocCount count;
+
+    count.allocs = allocs.load(memory_order_relaxed);
+    count.bytes = bytes.load(memory_order_relaxed);
+
+    return count;
+}
+
+void *operator new(size_t n)
+{
+    allocs.fetch_add(1, memory_order_relaxed);
+    bytes.fetch_add(n, memory_order_relaxed);
+
+    void *p = malloc(n ? n : 1);
+
+    if (p == NULL)
+        throw bad_alloc();
+
+    return p;
+}
+
+void *operator new[](size_t n)
+{
+    return operator new(n);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
@@ -0,0 +1,20 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <stddef.h>
+
+//heap allocation counters for the benchmarks.
+//linking allocCounter.cpp replaces the global operator new and delete with counting versions,
+//so only the benchmark binaries link it.
+
+typedef struct
+{
+    long allocs; //calls of operator new
+    long bytes;  //bytes requested from operator new
+
+} AllocCount;
+
+//allocations made by all threads since the program started
+AllocCount allocCount();
+
+#endif
@@ -1,6 +1,11 @@
 #include "approxmatch.h"
 
 #define MIN(x, y) (((x) < (y)) ? (x) : (y))
+#define MAX(x, y) (((x) > (y)) ? (x) : (y))
+
+#define SIMDMINLEN 64 //below this levDistanceSimd does not pay for its setup
+
+#define BPWORDS 16 //the bit-parallel kernels take patterns of up to BPWORDS * 64 characters
 
 int getListLen(string list)
 {
@@ -12,7 +17,7 @@ char get_char_by_index(string head, int n)
     return head[n];
 }
 
-int approxmatch(string  pattern, string  text, int k, int type)
+int approxmatch(const string &pattern, const string &text, int k, int type)
 {
     if(type == 0)
     {
@@ -21,14 +26,44 @@ int approxmatch(string  pattern, string  text, int k, int type)
 
     if(type == 1)
     {
-        int distance = levDistance(pattern, text);
-        if(distance > k) return -1;
+        return approxmatchText(pattern.data(), pattern.length(), text.data(), text.length(), k);
+    }
+
+    if(type == 2)
+    {
+        return ukkonenwood(pattern, text, k) < 0 ? -1 : 0;
+    }
+
+    if(type == 3)
+    {
+        return galilpark(pattern, text, k) < 0 ? -1 : 0;
+    }
+
+    if(type == 4)
+    {
+        return bitparallel(pattern, text, k) < 0 ? -1 : 0;
     }
 
     return 0;
 }
 
-int exactmatch(string  pattern, string  text)
+int approxmatchText(const char *pattern, int plen, const char *text, int tlen, int k)
+{
+    //banded DP with early exit.
+    //on long strings whose band covers about half of the matrix the vectorized full matrix is cheaper.
+    //that needs k >= (SIMDMINLEN - 2) / 4, so PSL windows (matchTol 2) always take the band.
+    int distance;
+    int shorter = MIN(plen, tlen);
+
+    if (shorter >= SIMDMINLEN && 4 * k + 2 >= shorter)
+        distance = levDistanceSimd(pattern, plen, text, tlen);
+    else
+        distance = levDistanceBounded(pattern, plen, text, tlen, k);
+
+    return distance > k ? -1 : 0;
+}
+
+int exactmatch(const string &pattern, const string &text)
 {
     if(pattern == text)
         return 0;
@@ -94,7 +129,7 @@ int dynamicprogramming(string  pattern, string  text, int k)
 
 //http://www.talkativeman.com/levenshtein-distance-algorithm-string-comparison/
 //source - base string, target - string to be modified
-int levDistance(string source, string target)
+int levDistance(const string &source, const string &target)
 {
     const int slen = source.length();
     const int tlen = target.length();
@@ -160,3 +195,337 @@ int levDistance(string source, string target)
 
 }
 
+
+int levDistanceBounded(const string &source, const string &target, int k)
+{
+    return levDistanceBounded(source.data(), source.length(), target.data(), target.length(), k);
+}
+
+int levDistanceBounded(const char *source, int slen, const char *target, int tlen, int k)
+{
+    //every cell satisfies D[i][j] >= |i - j| (only insertions and deletions change i - j and they cost 1),
+    //so cells off the band |i - j| <= k cannot lead to a distance <= k. values are saturated at k + 1,
+    //which keeps min(D, k + 1) exact.
+
+    static thread_local vector<int> scratch;
+
+    const int inf = k + 1;
+
+    if (abs(slen - tlen) > k) return inf;
+    if (slen == 0) return MIN(tlen, inf);
+    if (tlen == 0) return MIN(slen, inf);
+
+    scratch.resize(3 * (tlen + 1));
+
+    int *prev2 = &scratch[0];             //row i - 2, for transpositions
+    int *prev = &scratch[tlen + 1];       //row i - 1
+    int *cur = &scratch[2 * (tlen + 1)];  //row i
+
+    int hi = MIN(tlen, k);
+
+    for (int j = 0; j <= hi; j++)
+    {
+        prev[j] = j;
+    }
+    if (hi < tlen) prev[hi + 1] = inf;
+
+    int prevmin = 0;
+
+    for (int i = 1; i <= slen; i++)
+    {
+        const char s_ = source[i - 1];
+
+        int lo = MAX(0, i - k);
+        hi = MIN(tlen, i + k);
+
+        if (lo > 0) cur[lo - 1] = inf;
+
+        int rowmin = inf;
+
+        for (int j = lo; j <= hi; j++)
+        {
+            int cell;
+
+            if (j == 0)
+                cell = i;
+            else
+            {
+                const char t_ = target[j - 1];
+
+                int cost;
+
+                if(s_ == t_) cost = 0;
+                else cost = abs( (int) s_ - t_ );
+
+                int above = prev[j];
+                int left = (j > lo) ? cur[j - 1] : inf;
+                int diag = prev[j - 1];
+
+                cell = MIN( above + 1, MIN (left + 1, diag + cost));
+
+                if( i > 2 && j > 2){
+                    int transposition = prev2[j - 2] + 1;
+
+                    if(source[i-2] != t_) transposition++;
+                    if(s_ != target[j-2]) transposition ++;
+
+                    if(cell > transposition) cell = transposition;
+                }
+            }
+
+            if (cell > inf) cell = inf;
+
+            cur[j] = cell;
+
+            if (cell < rowmin) rowmin = cell;
+        }
+
+        if (hi < tlen) cur[hi + 1] = inf;
+
+        //row i + 1 reads rows i and i - 1 (the latter through a transposition, +1 at least)
+        if (rowmin > k && prevmin >= k) return inf;
+
+        prevmin = rowmin;
+
+        int *tmp = prev2;
+        prev2 = prev;
+        prev = cur;
+        cur = tmp;
+    }
+
+    return prev[tlen];
+}
+
+//Myers' bit-vector algorithm in Hyyro's formulation, computing the global distance D[m][n].
+//bit i of a word holds the vertical delta of row i + 1 in the current column.
+//returns the distance, or k + 1 as soon as D[m][j] - (n - j) shows it must exceed k.
+static int bitvectorDistance(const char *p, int m, const char *t, int n, int k)
+{
+    static thread_local uint64_t peq[256][BPWORDS];
+
+    const int words = (m + 63) / 64;
+    const int lastbit = (m - 1) % 64;
+
+    uint64_t vp[BPWORDS], vn[BPWORDS];
+
+    for (int i = 0; i < m; i++)
+    {
+        peq[(unsigned char) p[i]][i / 64] |= (uint64_t) 1 << (i % 64);
+    }
+
+    for (int w = 0; w < words; w++)
+    {
+        vp[w] = ~(uint64_t) 0;
+        vn[w] = 0;
+    }
+
+    int score = m;
+    bool exceeded = false;
+
+    for (int j = 0; j < n && !exceeded; j++)
+    {
+        const uint64_t *eq = peq[(unsigned char) t[j]];
+
+        //row 0 is D[0][j] = j, so a +1 horizontal delta enters at the bottom of the first word
+        uint64_t hpcarry = 1, hncarry = 0, addcarry = 0;
+
+        for (int w = 0; w < words; w++)
+        {
+            uint64_t e = eq[w];
+            uint64_t x = e | vn[w];
+
+            uint64_t a = e & vp[w];
+            uint64_t sum = a + vp[w];
+            uint64_t carry = sum < a;
+            sum += addcarry;
+            carry |= sum < addcarry;
+            addcarry = carry;
+
+            uint64_t d0 = (sum ^ vp[w]) | x;
+
+            uint64_t hp = vn[w] | ~(d0 | vp[w]);
+            uint64_t hn = vp[w] & d0;
+
+            if (w == words - 1)
+            {
+                score += (hp >> lastbit) & 1;
+                score -= (hn >> lastbit) & 1;
+            }
+
+            uint64_t hps = (hp << 1) | hpcarry;
+            uint64_t hns = (hn << 1) | hncarry;
+            hpcarry = hp >> 63;
+            hncarry = hn >> 63;
+
+            vp[w] = hns | ~(d0 | hps);
+            vn[w] = hps & d0;
+        }
+
+        //each remaining column can lower D[m][j] by at most one
+        if (score - (n - 1 - j) > k) exceeded = true;
+    }
+
+    for (int i = 0; i < m; i++)
+    {
+        peq[(unsigned char) p[i]][i / 64] = 0;
+    }
+
+    if (exceeded || score > k) return k + 1;
+
+    return score;
+}
+
+int bitparallel(const string &pattern, const string &text, int k)
+{
+    const string &p = pattern.length() <= text.length() ? pattern : text;
+    const string &t = pattern.length() <= text.length() ? text : pattern;
+
+    int m = p.length();
+    int n = t.length();
+
+    if (n - m > k) return -1;
+    if (m == 0) return n;
+
+    if (m > BPWORDS * 64) return ukkonenwood(pattern, text, k);
+
+    int distance = bitvectorDistance(p.data(), m, t.data(), n, k);
+
+    return distance > k ? -1 : distance;
+}
+
+int ukkonenwood(const string &pattern, const string &text, int k)
+{
+    //Ukkonen's cut-off, column by column with unit costs. D[i][j] >= |i - j| and D[i][j] >= D[i-1][j-1],
+    //so only rows j - k .. lact + 1 can be <= k, where lact is the last active (<= k) row of the previous column.
+    //cells outside that range count as k + 1.
+
+    static thread_local vector<int> columns;
+
+    const int m = pattern.length();
+    const int n = text.length();
+
+    if (abs(m - n) > k) return -1;
+
+    columns.resize(2 * (m + 1));
+
+    int *prev = &columns[0];
+    int *cur = &columns[m + 1];
+
+    int first = 0;
+    int lact = MIN(k, m);
+
+    for (int i = 0; i <= lact; i++)
+    {
+        prev[i] = i;
+    }
+
+    for (int j = 1; j <= n; j++)
+    {
+        const char t_ = text[j - 1];
+
+        int newfirst = MAX(0, j - k);
+        int last = MIN(m, lact + 1);
+        int newlact = -1;
+
+        for (int i = newfirst; i <= last; i++)
+        {
+            int cell;
+
+            if (i == 0)
+                cell = j;
+            else
+            {
+                int cost = (pattern[i - 1] == t_) ? 0 : 1;
+
+                int diag = (i - 1 >= first && i - 1 <= lact) ? prev[i - 1] : k + 1;
+                int left = (i >= first && i <= lact) ? prev[i] : k + 1;
+                int above = (i - 1 >= newfirst) ? cur[i - 1] : k + 1;
+
+                cell = MIN(diag + cost, MIN(left + 1, above + 1));
+            }
+
+            if (cell > k) cell = k + 1;
+            else newlact = i;
+
+            cur[i] = cell;
+        }
+
+        if (newlact < 0) return -1;
+
+        first = newfirst;
+        lact = newlact;
+
+        int *tmp = prev;
+        prev = cur;
+        cur = tmp;
+    }
+
+    if (lact < m || prev[m] > k) return -1;
+
+    return prev[m];
+}
+
+int galilpark(const string &pattern, const string &text, int k)
+{
+    //diagonal transition: L[d] is the furthest row reached on diagonal d = j - i with e errors,
+    //extended along matching characters. the first e for which diagonal n - m reaches row m is the distance.
+
+    static thread_local vector<int> diagonals;
+
+    const int m = pattern.length();
+    const int n = text.length();
+
+    if (abs(m - n) > k) return -1;
+
+    const int width = 2 * k + 3;
+    const int offset = k + 1;
+    const int target = n - m;
+    const int unreached = -1 - m - n;
+
+    diagonals.assign(2 * width, unreached);
+
+    int *prev = &diagonals[0];
+    int *cur = &diagonals[width];
+
+    for (int e = 0; e <= k; e++)
+    {
+        for (int d = -e; d <= e; d++)
+        {
+            if (d < -m || d > n)
+            {
+                cur[d + offset] = unreached;
+                continue;
+            }
+
+            int row;
+
+            if (e == 0)
+                row = 0;
+            else
+            {
+                row = prev[d + offset] + 1;                              //substitution
+                row = MAX(row, prev[d - 1 + offset]);                    //insertion
+                row = MAX(row, prev[d + 1 + offset] + 1);                //deletion
+            }
+
+            if (row < -d) row = -d;
+            if (row > m) row = m;
+            if (row + d > n) row = n - d;
+
+            while (row < m && row + d < n && pattern[row] == text[row + d])
+            {
+                row++;
+            }
+
+            cur[d + offset] = row;
+        }
+
+        if (abs(target) <= e && cur[target + offset] >= m) return e;
+
+        int *tmp = prev;
+        prev = cur;
+        cur = tmp;
+    }
+
+    return -1;
+}
@@ -1,19 +1,32 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string>
 #include <unistd.h>
 #include <vector>
 
 using namespace std;
 
-int exactmatch(string pattern, string text);
+//approxmatch types
+//0 - exact, 1 - levDistance (weighted substitution + transposition), 2 - ukkonenwood, 3 - galilpark, 4 - bitparallel
+//types 2-4 are unit-cost Levenshtein distances bounded by k
+
+int exactmatch(const string &pattern, const string &text);
 
 //if k=0 exactmatch
 int dynamicprogramming(string pattern, string text, int k);
 
-int galilpark(char** pattern, char** text, int k);
+//k-bounded unit-cost Levenshtein kernels: return the distance if it is <= k, otherwise -1.
+//none of them allocates on the hot path.
+
+//diagonal transition (Galil-Park / Landau-Vishkin): furthest reaching row per diagonal and error count
+int galilpark(const string &pattern, const string &text, int k);
 
-int ukkonenwood(char** pattern, char** text, int k);
+//Ukkonen's cut-off DP: only the rows of a column that can still be <= k are computed
+int ukkonenwood(const string &pattern, const string &text, int k);
+
+//Myers/Hyyro bit-vector algorithm on 64-bit words, multi-word for patterns longer than 64
+int bitparallel(const string &pattern, const string &text, int k);
 
 int boyermoore(char** pattern, char** text, int k);
 
@@ -21,6 +34,36 @@ int exactmatch_(string  pattern, string  text);
 
 int getListLen(string list);
 
-int approxmatch(string  pattern, string  text, int k, int type);
+int approxmatch(const string &pattern, const string &text, int k, int type);
+
+//approxmatch type 1 on character buffers: 0 if the levDistance is <= k, -1 otherwise
+int approxmatchText(const char *pattern, int plen, const char *text, int tlen, int k);
+
+int levDistance(const string &source, const string &target);
+
+//levDistance restricted to the 2k+1 diagonals around the main one, with the same substitution
+//and transposition costs. returns min(levDistance, k + 1) using thread-local scratch rows.
+int levDistanceBounded(const string &source, const string &target, int k);
+
+int levDistanceBounded(const char *source, int slen, const char *target, int tlen, int k);
+
+//levDistance evaluated along anti-diagonals with 16-bit SIMD lanes, same result as levDistance.
+//it computes the full matrix, so approxmatchText only uses it for strings of 64 or more characters
+//when k is at least 16. PSL windows are matched with small tolerances and stay on levDistanceBounded.
+
+#define LEV_SCALAR 0
+#define LEV_SSE41 1
+#define LEV_AVX2 2
+
+//best instruction set available at runtime
+int levDistanceIsaSupported();
+
+//forces one code path, for benchmarking
+int levDistanceIsa(const string &source, const string &target, int isa);
+
+int levDistanceIsa(const char *source, int slen, const char *target, int tlen, int isa);
+
+//dispatches to the best supported path
+int levDistanceSimd(const string &source, const string &target);
 
-int levDistance(string source, string target);
\ No newline at end of file
+int levDistanceSimd(const char *source, int slen, const char *target, int tlen);
@@ -0,0 +1,251 @@
+#include "approxmatch.h"
+#include <immintrin.h>
+
+//anti-diagonal evaluation of the levDistance recurrence.
+//all cells on a diagonal d = i + j depend only on diagonals d - 1 (above, left), d - 2 (substitution)
+//and d - 4 (transposition), so a diagonal is computed in parallel across rows i with 16-bit lanes.
+//diagonal buffers are indexed by i; the target is stored reversed so t[d - i - 1] is contiguous in i.
+
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+#define MAX(x, y) (((x) > (y)) ? (x) : (y))
+
+#define DIAGONALS 5 //d, d - 1, d - 2, d - 3, d - 4
+#define PADDING 32
+
+//16-bit lanes: D[i][j] <= i + j must stay below 32767
+#define MAXSIMDLEN 16000
+
+typedef struct
+{
+    const short *s;   //source widened, s[i] = source[i]
+    const short *tr;  //target widened and reversed, tr[x] = target[n - 1 - x]
+    int m;
+    int n;
+
+} LevInput;
+
+//diagonal d and the diagonals it reads
+typedef struct
+{
+    short *cur;
+    const short *prev1;
+    const short *prev2;
+    const short *prev4;
+    int d;
+
+} LevDiagonal;
+
+static thread_local vector<short> simdScratch;
+
+//one cell of the diagonal, row i, exactly as in levDistance
+static inline short levCell(const LevInput &in, const LevDiagonal &dg, int i)
+{
+    const int j = dg.d - i;
+
+    if (i == 0) return j;
+    if (j == 0) return i;
+
+    const int s_ = in.s[i - 1];
+    const int t_ = in.tr[in.n - j];
+
+    int cost = abs(s_ - t_);
+
+    int cell = MIN(dg.prev1[i - 1] + 1, MIN(dg.prev1[i] + 1, dg.prev2[i - 1] + cost));
+
+    if (i > 2 && j > 2)
+    {
+        int transposition = dg.prev4[i - 2] + 1;
+
+        if (in.s[i - 2] != t_) transposition++;
+        if (s_ != in.tr[in.n - j + 1]) transposition++;
+
+        if (cell > transposition) cell = transposition;
+    }
+
+    return cell;
+}
+
+static void levBodyScalar(const LevInput &in, const LevDiagonal &dg, int lo, int hi)
+{
+    for (int i = lo; i <= hi; i++)
+    {
+        dg.cur[i] = levCell(in, dg, i);
+    }
+}
+
+//8 cells of a diagonal starting at row i, all with a transposition term (i > 2 and j > 2).
+//t[j - 1] = tr[n - d + i], t[j - 2] = tr[n - d + i + 1]
+#define LEV_STEP_128(in, dg, i, one)                                                            \
+    {                                                                                            \
+        __m128i s1 = _mm_loadu_si128((const __m128i *) (in.s + i - 1));                         \
+        __m128i s2 = _mm_loadu_si128((const __m128i *) (in.s + i - 2));                         \
+        __m128i t1 = _mm_loadu_si128((const __m128i *) (in.tr + in.n - dg.d + i));               \
+        __m128i t2 = _mm_loadu_si128((const __m128i *) (in.tr + in.n - dg.d + i + 1));           \
+                                                                                                 \
+        __m128i above = _mm_loadu_si128((const __m128i *) (dg.prev1 + i - 1));                   \
+        __m128i left = _mm_loadu_si128((const __m128i *) (dg.prev1 + i));                        \
+        __m128i diag = _mm_loadu_si128((const __m128i *) (dg.prev2 + i - 1));                    \
+        __m128i trans = _mm_loadu_si128((const __m128i *) (dg.prev4 + i - 2));                   \
+                                                                                                 \
+        __m128i cost = _mm_abs_epi16(_mm_sub_epi16(s1, t1));                                     \
+                                                                                                 \
+        __m128i cell = _mm_min_epi16(_mm_add_epi16(above, one), _mm_add_epi16(left, one));       \
+        cell = _mm_min_epi16(cell, _mm_add_epi16(diag, cost));                                   \
+                                                                                                 \
+        /* +1, plus one for each mismatched half of the swap */                                  \
+        __m128i t = _mm_add_epi16(trans, one);                                                   \
+        t = _mm_add_epi16(t, _mm_andnot_si128(_mm_cmpeq_epi16(s2, t1), one));                    \
+        t = _mm_add_epi16(t, _mm_andnot_si128(_mm_cmpeq_epi16(s1, t2), one));                    \
+                                                                                                 \
+        _mm_storeu_si128((__m128i *) (dg.cur + i), _mm_min_epi16(cell, t));                      \
+    }
+
+__attribute__((target("sse4.1")))
+static void levBodySse41(const LevInput &in, const LevDiagonal &dg, int lo, int hi)
+{
+    const __m128i one = _mm_set1_epi16(1);
+
+    int i = lo;
+
+    for (; i + 8 <= hi + 1; i += 8)
+    {
+        LEV_STEP_128(in, dg, i, one);
+    }
+
+    levBodyScalar(in, dg, i, hi);
+}
+
+__attribute__((target("avx2")))
+static void levBodyAvx2(const LevInput &in, const LevDiagonal &dg, int lo, int hi)
+{
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m128i one128 = _mm_set1_epi16(1);
+
+    int i = lo;
+
+    for (; i + 16 <= hi + 1; i += 16)
+    {
+        __m256i s1 = _mm256_loadu_si256((const __m256i *) (in.s + i - 1));
+        __m256i s2 = _mm256_loadu_si256((const __m256i *) (in.s + i - 2));
+        __m256i t1 = _mm256_loadu_si256((const __m256i *) (in.tr + in.n - dg.d + i));
+        __m256i t2 = _mm256_loadu_si256((const __m256i *) (in.tr + in.n - dg.d + i + 1));
+
+        __m256i above = _mm256_loadu_si256((const __m256i *) (dg.prev1 + i - 1));
+        __m256i left = _mm256_loadu_si256((const __m256i *) (dg.prev1 + i));
+        __m256i diag = _mm256_loadu_si256((const __m256i *) (dg.prev2 + i - 1));
+        __m256i trans = _mm256_loadu_si256((const __m256i *) (dg.prev4 + i - 2));
+
+        __m256i cost = _mm256_abs_epi16(_mm256_sub_epi16(s1, t1));
+
+        __m256i cell = _mm256_min_epi16(_mm256_add_epi16(above, one), _mm256_add_epi16(left, one));
+        cell = _mm256_min_epi16(cell, _mm256_add_epi16(diag, cost));
+
+        __m256i t = _mm256_add_epi16(trans, one);
+        t = _mm256_add_epi16(t, _mm256_andnot_si256(_mm256_cmpeq_epi16(s2, t1), one));
+        t = _mm256_add_epi16(t, _mm256_andnot_si256(_mm256_cmpeq_epi16(s1, t2), one));
+
+        _mm256_storeu_si256((__m256i *) (dg.cur + i), _mm256_min_epi16(cell, t));
+    }
+
+    //the 8-lane remainder is VEX encoded here, no switch back to legacy SSE code
+    for (; i + 8 <= hi + 1; i += 8)
+    {
+        LEV_STEP_128(in, dg, i, one128);
+    }
+
+    levBodyScalar(in, dg, i, hi);
+}
+
+int levDistanceIsaSupported()
+{
+    if (__builtin_cpu_supports("avx2")) return LEV_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return LEV_SSE41;
+
+    return LEV_SCALAR;
+}
+
+int levDistanceIsa(const string &source, const string &target, int isa)
+{
+    return levDistanceIsa(source.data(), source.length(), target.data(), target.length(), isa);
+}
+
+int levDistanceIsa(const char *source, int m, const char *target, int n, int isa)
+{
+    if (m == 0) return n;
+    if (n == 0) return m;
+
+    if (m + n > MAXSIMDLEN) return levDistance(string(source, m), string(target, n));
+
+    void (*body)(const LevInput &, const LevDiagonal &, int, int) = levBodyScalar;
+
+    if (isa == LEV_AVX2) body = levBodyAvx2;
+    else if (isa == LEV_SSE41) body = levBodySse41;
+
+    //layout: widened source, reversed widened target, then DIAGONALS diagonal buffers, each padded
+    //so vector loads at i - 2 and stores past hi stay inside the scratch buffer
+    const int stride = m + 1 + 2 * PADDING;
+
+    simdScratch.resize((m + PADDING) + (n + PADDING) + DIAGONALS * stride + PADDING);
+
+    short *s = &simdScratch[0];
+    short *tr = s + m + PADDING;
+    short *base = tr + n + PADDING + PADDING;
+
+    for (int i = 0; i < m; i++)
+    {
+        s[i] = source[i];
+    }
+
+    for (int x = 0; x < n; x++)
+    {
+        tr[x] = target[n - 1 - x];
+    }
+
+    LevInput in;
+    in.s = s;
+    in.tr = tr;
+    in.m = m;
+    in.n = n;
+
+    LevDiagonal dg;
+
+    for (int d = 0; d <= m + n; d++)
+    {
+        const int lo = MAX(0, d - n);
+        const int hi = MIN(m, d);
+
+        dg.d = d;
+        dg.cur = base + (d % DIAGONALS) * stride;
+        dg.prev1 = base + ((d + DIAGONALS - 1) % DIAGONALS) * stride;
+        dg.prev2 = base + ((d + DIAGONALS - 2) % DIAGONALS) * stride;
+        dg.prev4 = base + ((d + DIAGONALS - 4) % DIAGONALS) * stride;
+
+        //rows with a transposition term: i >= 3 and j = d - i >= 3
+        const int vlo = MAX(lo, 3);
+        const int vhi = MIN(hi, d - 3);
+
+        if (vlo > vhi)
+        {
+            levBodyScalar(in, dg, lo, hi);
+            continue;
+        }
+
+        levBodyScalar(in, dg, lo, vlo - 1);
+        body(in, dg, vlo, vhi);
+        levBodyScalar(in, dg, vhi + 1, hi);
+    }
+
+    return base[((m + n) % DIAGONALS) * stride + m];
+}
+
+int levDistanceSimd(const string &source, const string &target)
+{
+    return levDistanceSimd(source.data(), source.length(), target.data(), target.length());
+}
+
+int levDistanceSimd(const char *source, int slen, const char *target, int tlen)
+{
+    static const int isa = levDistanceIsaSupported();
+
+    return levDistanceIsa(source, slen, target, tlen, isa);
+}
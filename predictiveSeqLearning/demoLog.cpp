@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <chrono>
+#include "demoLog.h"
+
+#define DEMOLOGIDLE 5 //ms the writer thread sleeps when there is nothing to write
+
+bool isDemoLog(const char *data, size_t length)
+{
+    if (length < sizeof(DemoLogHeader))
+        return false;
+
+    const DemoLogHeader *header = (const DemoLogHeader *) data;
+
+    return strncmp(header->magic, DEMOLOG_MAGIC, sizeof(header->magic)) == 0;
+}
+
+uint64_t demoLogTime()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+bool writeDemoLogHeader(FILE *outFile)
+{
+    DemoLogHeader header;
+
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, DEMOLOG_MAGIC, sizeof(header.magic));
+    header.version = DEMOLOG_VERSION;
+    header.recordSize = sizeof(DemoLogRecord);
+
+    return fwrite(&header, sizeof(header), 1, outFile) == 1;
+}
+
+bool writeDemoRecords(FILE *outFile, int format, const DemoLogRecord *records, int count)
+{
+    if (format == DEMOLOG_BINARY)
+        return count == 0 || fwrite(records, sizeof(DemoLogRecord), count, outFile) == (size_t) count;
+
+    for (int i = 0; i < count; i++)
+    {
+        const Action &a = records[i].event.action;
+
+        if (records[i].type == DEMOLOG_FINISH)
+            fprintf(outFile, "%s\n", "finish");
+        else
+            fprintf(outFile, " %d %d %d %d %d\n", a.deltaX, a.deltaY, a.deltaZ, a.deltaangle, a.grasp);
+    }
+
+    return !ferror(outFile);
+}
+
+DemoLogWriter::DemoLogWriter() : ring(DEMOLOGRING), head(0), tail(0), drops(0), stop(false)
+{
+    file = NULL;
+    pairDropped = false;
+    format = DEMOLOG_TEXT;
+}
+
+DemoLogWriter::~DemoLogWriter()
+{
+    close();
+}
+
+bool DemoLogWriter::open(const char *path, int format)
+{
+    close();
+
+    file = fopen(path, format == DEMOLOG_BINARY ? "ab" : "a");
+
+    if (file == NULL)
+        return false;
+
+    this->format = format;
+
+    fseek(file, 0, SEEK_END);
+
+    if (format == DEMOLOG_BINARY)
+    {
+        //a record (or header) cut short by a crash would misalign every record appended after it:
+        //the log is cut back to its last whole record first
+        long size = ftell(file);
+        long whole = 0;
+
+        if (size >= (long) sizeof(DemoLogHeader))
+            whole = sizeof(DemoLogHeader) + (size - sizeof(DemoLogHeader)) / sizeof(DemoLogRecord) * sizeof(DemoLogRecord);
+
+        if (whole != size && ftruncate(fileno(file), whole) != 0)
+        {
+            fclose(file);
+            file = NULL;
+            return false;
+        }
+
+        fseek(file, 0, SEEK_END);
+
+        if (whole == 0)
+            writeDemoLogHeader(file);
+    }
+
+    head = tail = 0;
+    pairDropped = false;
+    drops = 0;
+    stop = false;
+    writer = thread(&DemoLogWriter::work, this);
+
+    return true;
+}
+
+void DemoLogWriter::push(const DemoLogRecord &record)
+{
+    size_t t = tail.load(memory_order_relaxed);
+    size_t free = ring.size() - (t - head.load(memory_order_acquire));
+
+    //the text format has no types: it alternates action and observation lines and splits on "finish".
+    //so a finish is never dropped, and an action is only taken with room for its observation, which
+    //is dropped with it otherwise. every event leaves a slot for the finish that may follow it.
+    if (record.type == DEMOLOG_FINISH)
+    {
+        //only a finish right after another one can find the ring full, and two boundaries are one
+        if (free == 0)
+            return;
+    }
+    else
+    {
+        bool drop = record.type == 1 ? free < 3 : (pairDropped || free < 2);
+
+        pairDropped = record.type == 1 && drop;
+
+        if (drop)
+        {
+            drops++;
+            return;
+        }
+    }
+
+    ring[t % ring.size()] = record;
+    tail.store(t + 1, memory_order_release);
+}
+
+void DemoLogWriter::event(EventUnion e, int eventtype)
+{
+    DemoLogRecord record;
+
+    memset(&record, 0, sizeof(record));
+    record.event = e;
+    record.type = eventtype;
+    record.timestamp = demoLogTime();
+
+    push(record);
+}
+
+void DemoLogWriter::finish()
+{
+    DemoLogRecord record;
+
+    memset(&record, 0, sizeof(record));
+    record.type = DEMOLOG_FINISH;
+    record.timestamp = demoLogTime();
+
+    push(record);
+}
+
+int DemoLogWriter::drain()
+{
+    size_t h = head.load(memory_order_relaxed);
+    size_t t = tail.load(memory_order_acquire);
+
+    int count = 0;
+
+    //the ready records, in at most two runs of the ring
+    while (h != t)
+    {
+        size_t first = h % ring.size();
+        size_t run = min(t - h, ring.size() - first);
+
+        writeDemoRecords(file, format, &ring[first], run);
+
+        h += run;
+        count += run;
+        head.store(h, memory_order_release);
+    }
+
+    if (count > 0)
+        fflush(file);
+
+    return count;
+}
+
+void DemoLogWriter::work()
+{
+    while (!stop.load(memory_order_acquire))
+    {
+        if (drain() == 0)
+            this_thread::sleep_for(chrono::milliseconds(DEMOLOGIDLE));
+    }
+
+    drain();
+}
+
+void DemoLogWriter::close()
+{
+    if (file == NULL)
+        return;
+
+    stop = true;
+    writer.join();
+
+    fclose(file);
+    file = NULL;
+}
@@ -0,0 +1,105 @@
+#ifndef DEMOLOG_H
+#define DEMOLOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "eventSeq.h"
+
+using namespace std;
+
+//demonstration logs: the legacy trainingdata text, or an append-only binary log of fixed size records
+//after a DemoLogHeader. a record is an event with its type and the time it was recorded, or a
+//demonstration boundary (the "finish" of the text format).
+
+#define DEMOLOG_TEXT 0   //" dx dy dz dangle grasp" lines and "finish"
+#define DEMOLOG_BINARY 1 //DemoLogHeader then DemoLogRecords
+
+#define DEMOLOG_MAGIC "PSLDEMO"
+#define DEMOLOG_VERSION 1
+#define DEMOLOG_FINISH 3   //record type of a demonstration boundary
+#define DEMOLOGRING 4096   //records buffered between the control loop and the writer thread
+
+typedef struct
+{
+    char magic[8];       //DEMOLOG_MAGIC
+    uint32_t version;    //DEMOLOG_VERSION
+    uint32_t recordSize; //sizeof(DemoLogRecord)
+
+} DemoLogHeader;
+
+typedef struct
+{
+    EventUnion event;
+    signed char type;    //1 action, 2 observation or DEMOLOG_FINISH
+    char reserved[2];
+    uint64_t timestamp;  //CLOCK_MONOTONIC_RAW, ns
+
+} DemoLogRecord;
+
+//true if the buffer starts with the header of a binary log
+bool isDemoLog(const char *data, size_t length);
+
+//starts a new binary log
+bool writeDemoLogHeader(FILE *outFile);
+
+//writes the records to a file opened for appending, in the given format
+bool writeDemoRecords(FILE *outFile, int format, const DemoLogRecord *records, int count);
+
+//monotonic time stamp of a record recorded now
+uint64_t demoLogTime();
+
+//appends records to a log from a real-time loop. event and finish only copy the record into a ring
+//buffer, a writer thread formats and writes it: the caller never waits for the disk. if the writer
+//falls DEMOLOGRING records behind, new events are dropped and counted rather than waited for: an action
+//and its observation are dropped together and finish is never dropped, so neither format mistypes
+//an event or merges two demonstrations. event and finish are called from one thread.
+
+class DemoLogWriter
+{
+public:
+    DemoLogWriter();
+
+    ~DemoLogWriter();
+
+    //opens the log for appending (a new binary log gets its header, a binary log torn by a crash is cut
+    //back to its last whole record) and starts the writer thread
+    bool open(const char *path, int format);
+
+    void event(EventUnion e, int eventtype);
+
+    //ends the demonstration
+    void finish();
+
+    //writes what is buffered and closes the file
+    void close();
+
+    //records lost to a full buffer
+    long dropped() const { return drops; }
+
+private:
+    DemoLogWriter(const DemoLogWriter &);
+    DemoLogWriter &operator=(const DemoLogWriter &);
+
+    void push(const DemoLogRecord &record);
+
+    //writes the buffered records, returns how many
+    int drain();
+
+    void work();
+
+    FILE *file;
+    int format;
+
+    vector<DemoLogRecord> ring;
+    atomic<size_t> head; //next record to write, owned by the writer thread
+    atomic<size_t> tail; //next free slot, owned by the caller
+    atomic<long> drops;
+    bool pairDropped; //the last action was dropped, its observation goes too. owned by the caller
+    atomic<bool> stop;
+    thread writer;
+};
+
+#endif
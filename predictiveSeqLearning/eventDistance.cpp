@@ -0,0 +1,73 @@
+#include "eventDistance.h"
+#include <stdlib.h>
+
+const EventCost defaultEventCost = { {1, 1, 1, 1, 1}, 3, 3 };
+
+int eventSeqDistance(EventView a, EventView b, const EventCost &cost, int k)
+{
+    const int alen = a.length();
+    const int blen = b.length();
+
+    //every length difference needs one insertion or deletion
+    if (abs(alen - blen) * cost.indel > k)
+        return k + 1;
+
+    //equal lengths and no room for an insertion/deletion pair: only the diagonal alignment is left.
+    //this is the case for every call from hypMatch.
+    if (alen == blen && 2 * cost.indel > k)
+    {
+        int d = 0;
+
+        for (int i = 0; i < alen; i++)
+        {
+            d += eventDistance(a[i], b[i], cost);
+
+            if (d > k)
+                return k + 1;
+        }
+
+        return d;
+    }
+
+    //general case: two-row DP over whole events, abandoned once a full row exceeds k
+
+    static thread_local vector<int> rows;
+
+    rows.resize(2 * (blen + 1));
+
+    int *prev = &rows[0];
+    int *cur = &rows[blen + 1];
+
+    for (int j = 0; j <= blen; j++)
+    {
+        prev[j] = j * cost.indel;
+    }
+
+    for (int i = 1; i <= alen; i++)
+    {
+        cur[0] = i * cost.indel;
+
+        int rowmin = cur[0];
+
+        for (int j = 1; j <= blen; j++)
+        {
+            int cell = prev[j - 1] + eventDistance(a[i - 1], b[j - 1], cost);
+
+            if (prev[j] + cost.indel < cell) cell = prev[j] + cost.indel;
+            if (cur[j - 1] + cost.indel < cell) cell = cur[j - 1] + cost.indel;
+
+            cur[j] = cell;
+
+            if (cell < rowmin) rowmin = cell;
+        }
+
+        if (rowmin > k)
+            return k + 1;
+
+        int *tmp = prev;
+        prev = cur;
+        cur = tmp;
+    }
+
+    return prev[blen] > k ? k + 1 : prev[blen];
+}
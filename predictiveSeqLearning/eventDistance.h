@@ -0,0 +1,49 @@
+#ifndef EVENTDISTANCE_H
+#define EVENTDISTANCE_H
+
+#include <stdlib.h>
+#include "eventSeq.h"
+
+//native event distance: works on the signed char fields of Observation/Action directly
+//instead of on their decimal text.
+
+//field order is the EventUnion layout: X, Y, Z, angle, grasp
+
+#define EVENTFIELDS 5
+
+typedef struct
+{
+    int field[EVENTFIELDS];   //cost per unit of |a - b| on each field
+    int type;                 //cost of aligning an action with an observation
+    int indel;                //cost of inserting or deleting a whole event
+
+} EventCost;
+
+//unit field costs; type mismatches and indels cost more than the default tolerance of 2
+extern const EventCost defaultEventCost;
+
+//distance between two single events, inline for the scoring loops.
+//the five fields of an action and of an observation share the same layout in EventUnion
+inline int eventDistance(const EventItem &a, const EventItem &b, const EventCost &cost)
+{
+    if (a.eventtype != b.eventtype)
+        return cost.type;
+
+    const signed char *fa = (const signed char *) &a.event;
+    const signed char *fb = (const signed char *) &b.event;
+
+    int d = 0;
+
+    for (int f = 0; f < EVENTFIELDS; f++)
+    {
+        d += cost.field[f] * abs((int) fa[f] - (int) fb[f]);
+    }
+
+    return d;
+}
+
+//edit distance between two event sequences, bounded by k.
+//returns the distance if it is <= k, otherwise k + 1 as soon as that is certain.
+int eventSeqDistance(EventView a, EventView b, const EventCost &cost, int k);
+
+#endif
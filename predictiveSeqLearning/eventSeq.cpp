@@ -0,0 +1,48 @@
+#include "eventSeq.h"
+
+EventItem makeEventItem(EventUnion val, int eventtype)
+{
+    EventItem item;
+
+    item.event = val;
+    item.eventtype = eventtype;
+
+    return item;
+}
+
+EventSeq::EventSeq(Event_t *head)
+{
+    for (Event_t *current = head; current != NULL; current = current->next)
+    {
+        if (current->eventtype != 0)
+            items.push_back(makeEventItem(current->event, current->eventtype));
+    }
+}
+
+void EventSeq::push(EventUnion val, int eventtype)
+{
+    items.push_back(makeEventItem(val, eventtype));
+}
+
+Event_t *EventSeq::toList() const
+{
+    //same shape as the lists built with push(): an empty sequence is a single placeholder node
+
+    Event_t *head = new Event_t();
+    Event_t *tail = head;
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (i > 0)
+        {
+            tail->next = new Event_t();
+            tail = tail->next;
+        }
+
+        tail->event = items[i].event;
+        tail->eventtype = items[i].eventtype;
+        tail->next = NULL;
+    }
+
+    return head;
+}
@@ -0,0 +1,148 @@
+#ifndef EVENTSEQ_H
+#define EVENTSEQ_H
+
+#include <stdio.h>
+#include <vector>
+
+using namespace std;
+
+typedef struct
+{
+    signed char diffX;
+    signed char diffY;
+    signed char diffZ;
+    signed char diffangle;
+    signed char grasp;
+
+} Observation;
+
+typedef struct
+{
+    signed char deltaX;
+    signed char deltaY;
+    signed char deltaZ;
+    signed char deltaangle;
+    signed char grasp;
+
+} Action;
+
+typedef union {
+    Observation observation;
+    Action action;
+
+} EventUnion;
+
+//eventtype 1 - Action, 2 - Observation, 0 - notdefined
+
+typedef struct Event
+{
+    EventUnion event;
+    int eventtype;
+    struct Event *next;
+
+} Event_t;
+
+//packed event: the 5 bytes of the event plus a one byte type tag, no link.
+//an EventItem with eventtype 0 stands for "no event" (e.g. a failed prediction)
+
+typedef struct
+{
+    EventUnion event;
+    signed char eventtype;
+
+} EventItem;
+
+//non-owning window (pointer + length) over contiguous events.
+//prefix, suffix and window views cost nothing; a view never outlives the sequence it points into
+//and is invalidated by appending to that sequence.
+
+struct EventView
+{
+    const EventItem *items;
+    int len;
+
+    EventView() : items(NULL), len(0) {}
+    EventView(const EventItem *items, int len) : items(items), len(len) {}
+
+    int length() const { return len; }
+    const EventItem &operator[](int n) const { return items[n]; }
+
+    //first n events (the whole view if n >= len)
+    EventView prefix(int n) const
+    {
+        if (n >= len)
+            return *this;
+
+        return EventView(items, n < 0 ? 0 : n);
+    }
+
+    //last n events (the whole view if n >= len)
+    EventView suffix(int n) const
+    {
+        if (n >= len)
+            return *this;
+        if (n < 0)
+            n = 0;
+
+        return EventView(items + len - n, n);
+    }
+
+    //events [startIndex, stopIndex), empty if the range is invalid
+    EventView window(int startIndex, int stopIndex) const
+    {
+        if (startIndex < 0 || stopIndex <= startIndex || stopIndex > len)
+            return EventView();
+
+        return EventView(items + startIndex, stopIndex - startIndex);
+    }
+
+    const EventItem &back() const { return items[len - 1]; }
+};
+
+//contiguous, length-carrying event sequence.
+//O(1) length and indexing, amortized O(1) append.
+
+class EventSeq
+{
+public:
+    EventSeq() {}
+
+    //copies a linked list, skipping placeholder nodes (eventtype 0)
+    explicit EventSeq(Event_t *head);
+
+    explicit EventSeq(EventView view) { assign(view); }
+
+    int length() const { return (int)items.size(); }
+
+    const EventItem &operator[](int n) const { return items[n]; }
+    EventItem &operator[](int n) { return items[n]; }
+
+    const EventItem *data() const { return items.empty() ? NULL : &items[0]; }
+
+    void push(const EventItem &item) { items.push_back(item); }
+    void push(EventUnion val, int eventtype);
+
+    void assign(EventView view) { items.assign(view.items, view.items + view.len); }
+
+    void reserve(int n) { items.reserve(n); }
+    void clear() { items.clear(); }
+
+    //drop the storage as well as the contents
+    void release() { vector<EventItem>().swap(items); }
+
+    EventView view() const { return EventView(data(), length()); }
+    EventView suffix(int n) const { return view().suffix(n); }
+    EventView prefix(int n) const { return view().prefix(n); }
+
+    operator EventView() const { return view(); }
+
+    //rebuilds an Event_t list for the linked-list entry points
+    Event_t *toList() const;
+
+private:
+    vector<EventItem> items;
+};
+
+EventItem makeEventItem(EventUnion val, int eventtype);
+
+#endif
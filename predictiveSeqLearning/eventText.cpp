@@ -0,0 +1,41 @@
+#include "eventText.h"
+
+void appendEventText(string &text, EventView events)
+{
+    for (int i = 0; i < events.length(); i++)
+    {
+        const EventItem &current = events[i];
+
+        if (current.eventtype == 1)
+        {
+            text += to_string((int)current.event.action.deltaX);
+            text += to_string((int)current.event.action.deltaY);
+            text += to_string((int)current.event.action.deltaZ);
+            text += to_string((int)current.event.action.deltaangle);
+            text += to_string((int)current.event.action.grasp);
+        }
+        else if (current.eventtype == 2)
+        {
+            text += to_string((int)current.event.observation.diffX);
+            text += to_string((int)current.event.observation.diffY);
+            text += to_string((int)current.event.observation.diffZ);
+            text += to_string((int)current.event.observation.diffangle);
+            text += to_string((int)current.event.observation.grasp);
+        }
+    }
+}
+
+void EventText::clear()
+{
+    text.clear();
+    starts.resize(1);
+}
+
+void EventText::append(EventView events)
+{
+    for (int i = 0; i < events.length(); i++)
+    {
+        appendEventText(text, events.window(i, i + 1));
+        starts.push_back(text.length());
+    }
+}
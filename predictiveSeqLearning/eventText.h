@@ -0,0 +1,39 @@
+#ifndef EVENTTEXT_H
+#define EVENTTEXT_H
+
+#include <string>
+#include <vector>
+#include "eventSeq.h"
+
+using namespace std;
+
+//appends the decimal text the string kernel (MATCH_STRING) compares: the fields of each event one after the other
+void appendEventText(string &text, EventView events);
+
+//decimal text of an event sequence with the offset of every event in it.
+//the text of a window of events is a span of the whole text, so the string kernel can compare
+//windows without building their text again.
+
+class EventText
+{
+public:
+    EventText() { starts.push_back(0); }
+
+    void clear();
+
+    void append(EventView events);
+
+    //events held
+    int length() const { return (int) starts.size() - 1; }
+
+    //text of the events [from, to)
+    const char *data(int from) const { return text.data() + starts[from]; }
+
+    int span(int from, int to) const { return starts[to] - starts[from]; }
+
+private:
+    string text;
+    vector<int> starts; //offset of every event, then the length of the text
+};
+
+#endif
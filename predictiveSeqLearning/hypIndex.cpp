@@ -0,0 +1,164 @@
+#include <string.h>
+#include <algorithm>
+#include "hypIndex.h"
+
+//keys use the low 48 bits, this one holds the hypotheses with an empty body
+#define EMPTYBODY UINT64_MAX
+
+HypIndex::HypIndex()
+{
+    mode = HYPINDEX_EXACT;
+    quantum = 1;
+    count = 0;
+}
+
+void HypIndex::configure(int mode, int quantum)
+{
+    this->mode = mode;
+    this->quantum = quantum < 1 ? 1 : quantum;
+
+    clear();
+}
+
+void HypIndex::clear()
+{
+    buckets.clear();
+    count = 0;
+}
+
+uint64_t HypIndex::key(const EventItem &e) const
+{
+    const signed char *f = (const signed char *) &e.event;
+
+    uint64_t k = (uint8_t) e.eventtype;
+
+    for (int i = 0; i < EVENTFIELDS; i++)
+    {
+        int v = (int) f[i] + 128;
+
+        if (mode == HYPINDEX_QUANTIZED)
+            v /= quantum;
+
+        k = (k << 8) | (uint8_t) v;
+    }
+
+    return k;
+}
+
+void HypIndex::add(int id, EventView body)
+{
+    if (mode == HYPINDEX_NONE)
+        return;
+
+    buckets[body.length() == 0 ? EMPTYBODY : key(body.back())].push_back(id);
+    count++;
+}
+
+void HypIndex::appendBucket(uint64_t k, vector<int> &ids) const
+{
+    unordered_map<uint64_t, vector<int> >::const_iterator it = buckets.find(k);
+
+    if (it != buckets.end())
+        ids.insert(ids.end(), it->second.begin(), it->second.end());
+}
+
+void HypIndex::candidatesExact(const EventItem &last, vector<int> &ids) const
+{
+    appendBucket(key(last), ids);
+    appendBucket(EMPTYBODY, ids);
+
+    //buckets are disjoint, the merge only has to restore id order
+    sort(ids.begin(), ids.end());
+}
+
+void HypIndex::candidatesQuantized(const EventItem &last, vector<int> &ids) const
+{
+    candidatesExact(last, ids);
+}
+
+//appends every field offset of weighted L1 norm <= budget, starting at field f
+static void enumerateBall(const EventCost &cost, int f, int budget, signed char *offset, vector<signed char> &ball)
+{
+    if (f == EVENTFIELDS)
+    {
+        ball.insert(ball.end(), offset, offset + EVENTFIELDS);
+        return;
+    }
+
+    int reach = budget / cost.field[f];
+
+    for (int d = -reach; d <= reach; d++)
+    {
+        offset[f] = d;
+        enumerateBall(cost, f + 1, budget - cost.field[f] * abs(d), offset, ball);
+    }
+
+    offset[f] = 0;
+}
+
+//field offsets of cost at most k. the last ball is kept per thread, so const lookups
+//from different threads do not share it
+static const vector<signed char> &costBall(const EventCost &cost, int k)
+{
+    static thread_local vector<signed char> ball;
+    static thread_local EventCost ballCost;
+    static thread_local int ballK = -1;
+
+    if (ballK == k && memcmp(&ballCost, &cost, sizeof(EventCost)) == 0)
+        return ball;
+
+    signed char offset[EVENTFIELDS] = {0, 0, 0, 0, 0};
+
+    ball.clear();
+    enumerateBall(cost, 0, k, offset, ball);
+
+    ballCost = cost;
+    ballK = k;
+
+    return ball;
+}
+
+bool HypIndex::candidatesWithin(const EventItem &last, const EventCost &cost, int k, vector<int> &ids) const
+{
+    //the tail events are only guaranteed to be aligned with each other, and to be of the same type,
+    //when neither an insertion/deletion pair nor a type mismatch fits within k
+    if (mode != HYPINDEX_EXACT || 2 * cost.indel <= k || cost.type <= k)
+        return false;
+
+    for (int f = 0; f < EVENTFIELDS; f++)
+    {
+        if (cost.field[f] <= 0)
+            return false;
+    }
+
+    const vector<signed char> &ball = costBall(cost, k);
+
+    const signed char *f = (const signed char *) &last.event;
+
+    EventItem probe = last;
+    signed char *pf = (signed char *) &probe.event;
+
+    for (size_t b = 0; b < ball.size(); b += EVENTFIELDS)
+    {
+        bool inRange = true;
+
+        for (int i = 0; i < EVENTFIELDS; i++)
+        {
+            int v = (int) f[i] + ball[b + i];
+
+            if (v < -128 || v > 127)
+                inRange = false;
+
+            pf[i] = (signed char) v;
+        }
+
+        if (inRange)
+            appendBucket(key(probe), ids);
+    }
+
+    appendBucket(EMPTYBODY, ids);
+
+    sort(ids.begin(), ids.end());
+
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef HYPINDEX_H
+#define HYPINDEX_H
+
+#include <stdint.h>
+#include <unordered_map>
+#include "eventSeq.h"
+#include "eventDistance.h"
+
+//inverted index from the last event of a hypothesis body to the hypothesis ids.
+//hypMatch always aligns the last event of the sequence with the last event of the body,
+//so only hypotheses whose last event is close to the sequence tail need a full match.
+
+#define HYPINDEX_NONE 0      //no index, every hypothesis is scored
+#define HYPINDEX_EXACT 1     //lossless: identical results to the full scan (exact and native kernels)
+#define HYPINDEX_QUANTIZED 2 //lossy: only the bucket of the quantized tail event is scored
+
+class HypIndex
+{
+public:
+    HypIndex();
+
+    //changing the mode or quantum empties the index; the caller re-adds the library
+    void configure(int mode, int quantum);
+
+    int getMode() const { return mode; }
+
+    void clear();
+
+    //hypotheses must be added in increasing id order.
+    //a hypothesis with an empty body matches any sequence and is returned by every lookup
+    void add(int id, EventView body);
+
+    //hypotheses whose last event equals last, used by the exact kernel (sorted ids)
+    void candidatesExact(const EventItem &last, vector<int> &ids) const;
+
+    //every hypothesis whose last event is within cost k of last (sorted ids).
+    //returns false when the cost model does not bound the tail event and every hypothesis has to be scored
+    bool candidatesWithin(const EventItem &last, const EventCost &cost, int k, vector<int> &ids) const;
+
+    //the quantized bucket of last (sorted ids)
+    void candidatesQuantized(const EventItem &last, vector<int> &ids) const;
+
+    int size() const { return count; }
+
+private:
+    uint64_t key(const EventItem &e) const;
+
+    void appendBucket(uint64_t k, vector<int> &ids) const;
+
+    unordered_map<uint64_t, vector<int> > buckets;
+    int mode;
+    int quantum;
+    int count;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include "hypLibrary.h"
+
+void HypLibrary::reserve(int hypotheses, int events)
+{
+    ids.reserve(hypotheses);
+    starts.reserve(hypotheses);
+    lengths.reserve(hypotheses);
+    hitCounts.reserve(hypotheses);
+    missCounts.reserve(hypotheses);
+    heads.reserve(hypotheses);
+    lastMatches.reserve(hypotheses);
+
+    pool.reserve(events);
+}
+
+void HypLibrary::clear()
+{
+    ids.clear();
+    starts.clear();
+    lengths.clear();
+    hitCounts.clear();
+    missCounts.clear();
+    heads.clear();
+    lastMatches.clear();
+
+    pool.clear();
+}
+
+void HypLibrary::release()
+{
+    vector<int>().swap(ids);
+    vector<int>().swap(starts);
+    vector<int>().swap(lengths);
+    vector<int>().swap(hitCounts);
+    vector<int>().swap(missCounts);
+    vector<EventItem>().swap(heads);
+    vector<long>().swap(lastMatches);
+
+    vector<EventItem>().swap(pool);
+}
+
+int HypLibrary::add(int id, EventView body, const EventItem &rhs, int hits, int misses, long step)
+{
+    ids.push_back(id);
+    starts.push_back(pool.size());
+    lengths.push_back(body.length());
+    hitCounts.push_back(hits);
+    missCounts.push_back(misses);
+    heads.push_back(rhs);
+    lastMatches.push_back(step);
+
+    if (body.length() > 0 && body.items >= pool.data() && body.items < pool.data() + pool.size())
+    {
+        //the body is a view into the pool itself: grow the pool first, then copy from the moved events
+        size_t offset = body.items - pool.data();
+
+        if (pool.size() + body.length() > pool.capacity())
+            pool.reserve(max(2 * pool.capacity(), pool.size() + body.length()));
+
+        for (int i = 0; i < body.length(); i++)
+        {
+            pool.push_back(pool[offset + i]);
+        }
+    }
+    else
+        pool.insert(pool.end(), body.items, body.items + body.length());
+
+    return ids.size() - 1;
+}
+
+void HypLibrary::compact(const vector<char> &keep)
+{
+    vector<EventItem> packed;
+    packed.reserve(pool.size());
+
+    int n = 0;
+
+    for (int slot = 0; slot < size(); slot++)
+    {
+        if (!keep[slot])
+            continue;
+
+        ids[n] = ids[slot];
+        lengths[n] = lengths[slot];
+        hitCounts[n] = hitCounts[slot];
+        missCounts[n] = missCounts[slot];
+        heads[n] = heads[slot];
+        lastMatches[n] = lastMatches[slot];
+
+        packed.insert(packed.end(), pool.begin() + starts[slot], pool.begin() + starts[slot] + lengths[slot]);
+        starts[n] = packed.size() - lengths[n];
+
+        n++;
+    }
+
+    ids.resize(n);
+    starts.resize(n);
+    lengths.resize(n);
+    hitCounts.resize(n);
+    missCounts.resize(n);
+    heads.resize(n);
+    lastMatches.resize(n);
+
+    //the packed pool is only as large as the retained bodies
+    vector<EventItem>(packed.begin(), packed.end()).swap(pool);
+}
+
+size_t HypLibrary::memoryUsage() const
+{
+    return (ids.capacity() + starts.capacity() + lengths.capacity() + hitCounts.capacity() + missCounts.capacity()) * sizeof(int)
+        + lastMatches.capacity() * sizeof(long) + (heads.capacity() + pool.capacity()) * sizeof(EventItem);
+}
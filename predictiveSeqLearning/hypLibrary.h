@@ -0,0 +1,79 @@
+#ifndef HYPLIBRARY_H
+#define HYPLIBRARY_H
+
+#include <stddef.h>
+#include <vector>
+#include "eventSeq.h"
+
+//hypothesis library stored as parallel arrays (structure of arrays).
+//every body lives in one shared event pool and is addressed by its offset and length, so a hypothesis
+//costs a few integers plus its events and there is no per-hypothesis allocation.
+//slots are numbered 0..size()-1 in insertion order. appending may move the pool: body views are
+//invalidated by add, like views into a growing EventSeq.
+
+class HypLibrary
+{
+public:
+    HypLibrary() {}
+
+    //preallocates room for hypotheses and for their events in the pool
+    void reserve(int hypotheses, int events);
+
+    //empties the library, keeping the storage
+    void clear();
+
+    //empties the library and returns the storage
+    void release();
+
+    //appends a hypothesis and returns its slot
+    int add(int id, EventView body, const EventItem &rhs, int hits, int misses, long step);
+
+    //keeps the slots with keep[slot] != 0, in their order, and packs the event pool.
+    //slots are renumbered: the caller rebuilds anything that refers to them
+    void compact(const vector<char> &keep);
+
+    int size() const { return (int) ids.size(); }
+
+    int id(int slot) const { return ids[slot]; }
+
+    EventView body(int slot) const { return EventView(pool.data() + starts[slot], lengths[slot]); }
+
+    int bodyLength(int slot) const { return lengths[slot]; }
+
+    //offset of the body in the event pool; the pool holds the bodies in slot order
+    int bodyStart(int slot) const { return starts[slot]; }
+
+    const EventItem &rhs(int slot) const { return heads[slot]; }
+
+    int hits(int slot) const { return hitCounts[slot]; }
+
+    int misses(int slot) const { return missCounts[slot]; }
+
+    void addHits(int slot, int value) { hitCounts[slot] += value; }
+
+    void addMisses(int slot, int value) { missCounts[slot] += value; }
+
+    //training step the hypothesis last matched in (or was created in)
+    long lastMatch(int slot) const { return lastMatches[slot]; }
+
+    void touch(int slot, long step) { lastMatches[slot] = step; }
+
+    //events held by the pool
+    int events() const { return (int) pool.size(); }
+
+    //bytes reserved by the arrays and the pool
+    size_t memoryUsage() const;
+
+private:
+    vector<int> ids;
+    vector<int> starts;
+    vector<int> lengths;
+    vector<int> hitCounts;
+    vector<int> missCounts;
+    vector<EventItem> heads;
+    vector<long> lastMatches;
+
+    vector<EventItem> pool;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "pslImplementation.h"
+#include "hypParser.h"
+#include "mappedFile.h"
+#include "textScanner.h"
+
+//event line of print_event: actions end with a space, observations do not
+static bool scanEvent(Scanner &s, EventItem &item)
+{
+    int v[5];
+
+    for (int f = 0; f < 5; f++)
+    {
+        if (!scanInt(s, v[f]))
+            return false;
+    }
+
+    EventUnion e;
+
+    e.action.deltaX = v[0];
+    e.action.deltaY = v[1];
+    e.action.deltaZ = v[2];
+    e.action.deltaangle = v[3];
+    e.action.grasp = v[4];
+
+    item = makeEventItem(e, s.p < s.end && *s.p == ' ' ? 1 : 2);
+
+    nextLine(s);
+
+    return true;
+}
+
+int parseHypotheses(const char *text, size_t length, PslModel &model)
+{
+    Scanner s;
+    s.p = text;
+    s.end = text + length;
+
+    static thread_local EventSeq lhs;
+    lhs.clear();
+
+    EventItem rhs;
+    int hits, misses;
+    int count = 0;
+
+    while (s.p < s.end)
+    {
+        if (blankLine(s))
+        {
+            nextLine(s);
+            continue;
+        }
+
+        if (scanWord(s, "->"))
+        {
+            nextLine(s);
+
+            if (!scanEvent(s, rhs))
+                return -1;
+
+            if (!scanWord(s, ":") || !scanWord(s, "hits") || !scanInt(s, hits) || !scanWord(s, ",")
+                || !scanWord(s, "misses") || !scanInt(s, misses))
+                return -1;
+
+            nextLine(s);
+
+            model.restoreHypothesis(lhs, rhs, hits, misses);
+            lhs.clear();
+            count++;
+        }
+        else
+        {
+            EventItem item;
+
+            if (!scanEvent(s, item))
+                return -1;
+
+            lhs.push(item);
+        }
+    }
+
+    return lhs.length() == 0 ? count : -1;
+}
+
+int loadHypothesisFile(const char *path, PslModel &model)
+{
+    MappedFile file;
+
+    if (!file.open(path, MAPPED_SEQUENTIAL))
+        return -1;
+
+    return parseHypotheses(file.data(), file.size(), model);
+}
+
+//arguments of a loadHypothesisFiles pass, one chunk per file
+typedef struct
+{
+    const vector<string> *paths;
+    const vector<PslModel *> *models;
+    vector<int> *counts;
+
+} LoadJob;
+
+static void loadTask(void *context, int chunk)
+{
+    LoadJob &job = *(LoadJob *) context;
+
+    (*job.counts)[chunk] = loadHypothesisFile((*job.paths)[chunk].c_str(), *(*job.models)[chunk]);
+}
+
+void loadHypothesisFiles(const vector<string> &paths, const vector<PslModel *> &models, int threads, vector<int> &counts)
+{
+    //every file goes to its own model, so the loads share nothing
+    ThreadPool pool;
+    pool.resize(threads);
+
+    counts.assign(paths.size(), -1);
+
+    LoadJob job;
+    job.paths = &paths;
+    job.models = &models;
+    job.counts = &counts;
+
+    pool.run(paths.size(), loadTask, &job);
+}
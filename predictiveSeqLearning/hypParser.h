@@ -0,0 +1,25 @@
+#ifndef HYPPARSER_H
+#define HYPPARSER_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "pslModel.h"
+
+using namespace std;
+
+//reader of the print_hypotheses text format: lhs event lines, "->", the rhs event line, ": hits N, misses M".
+//action lines end with a space and observation lines do not, as print_event writes them.
+//the integers are scanned by hand straight from the buffer, nothing is copied or tokenised.
+
+//appends the hypotheses in text[0, length) to the library of the model. returns how many were read,
+//or -1 if the text is not in the format (the hypotheses before the error are kept)
+int parseHypotheses(const char *text, size_t length, PslModel &model);
+
+//maps the file and parses it, -1 if it can't be read or parsed
+int loadHypothesisFile(const char *path, PslModel &model);
+
+//loads paths[i] into *models[i] on up to threads threads; counts[i] is what loadHypothesisFile returned
+void loadHypothesisFiles(const vector<string> &paths, const vector<PslModel *> &models, int threads, vector<int> &counts);
+
+#endif
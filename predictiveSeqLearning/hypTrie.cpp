@@ -0,0 +1,222 @@
+#include <algorithm>
+#include "hypTrie.h"
+
+//type tag and the 5 event bytes
+static uint64_t eventKey(const EventItem &e)
+{
+    const unsigned char *f = (const unsigned char *) &e.event;
+
+    uint64_t k = (uint8_t) e.eventtype;
+
+    for (int i = 0; i < 5; i++)
+    {
+        k = (k << 8) | f[i];
+    }
+
+    return k;
+}
+
+HypTrie::HypTrie()
+{
+    clear();
+}
+
+void HypTrie::clear()
+{
+    trie.clear();
+    edges.clear();
+    nodeOf.clear();
+    confOf.clear();
+
+    Node root;
+    root.depth = 0;
+    root.best = -1;
+
+    trie.push_back(root);
+}
+
+int HypTrie::child(int node, const EventItem &e) const
+{
+    unordered_map<pair<int, uint64_t>, int, EdgeHash>::const_iterator it = edges.find(make_pair(node, eventKey(e)));
+
+    return it == edges.end() ? -1 : it->second;
+}
+
+bool HypTrie::better(int a, int b) const
+{
+    return confOf[a] > confOf[b] || (confOf[a] == confOf[b] && a < b);
+}
+
+void HypTrie::rescan(int node)
+{
+    Node &n = trie[node];
+
+    n.best = -1;
+
+    for (size_t i = 0; i < n.terminal.size(); i++)
+    {
+        if (n.best == -1 || better(n.terminal[i], n.best))
+            n.best = n.terminal[i];
+    }
+}
+
+void HypTrie::insert(int id, EventView body, double conf)
+{
+    int node = 0;
+
+    for (int d = body.length() - 1; d >= 0; d--)
+    {
+        int next = child(node, body[d]);
+
+        if (next == -1)
+        {
+            Node n;
+            n.depth = trie[node].depth + 1;
+            n.best = -1;
+
+            next = trie.size();
+            trie.push_back(n);
+            trie[node].children.push_back(next);
+
+            edges[make_pair(node, eventKey(body[d]))] = next;
+        }
+
+        node = next;
+    }
+
+    if ((int) nodeOf.size() <= id)
+    {
+        nodeOf.resize(id + 1, -1);
+        confOf.resize(id + 1, 0.0);
+    }
+
+    nodeOf[id] = node;
+    confOf[id] = conf;
+
+    Node &n = trie[node];
+    n.terminal.push_back(id);
+
+    if (n.best == -1 || better(id, n.best))
+        n.best = id;
+}
+
+void HypTrie::update(int id, double conf)
+{
+    if (id >= (int) nodeOf.size() || nodeOf[id] == -1)
+        return;
+
+    confOf[id] = conf;
+
+    Node &n = trie[nodeOf[id]];
+
+    if (n.best == id)
+        rescan(nodeOf[id]);
+    else if (better(id, n.best))
+        n.best = id;
+}
+
+void HypTrie::candidates(EventView sequence, vector<int> &ids) const
+{
+    ids.clear();
+
+    int node = 0;
+    int d = 0;
+
+    ids.insert(ids.end(), trie[0].terminal.begin(), trie[0].terminal.end());
+
+    while (d < sequence.length())
+    {
+        node = child(node, sequence[sequence.length() - 1 - d]);
+
+        if (node == -1)
+            break;
+
+        ids.insert(ids.end(), trie[node].terminal.begin(), trie[node].terminal.end());
+        d++;
+    }
+
+    //the whole sequence is a suffix of the longer bodies below the last node
+    if (node != -1 && d > 0 && d == sequence.length())
+    {
+        static thread_local vector<int> stack;
+        stack.assign(trie[node].children.begin(), trie[node].children.end());
+
+        while (!stack.empty())
+        {
+            const Node &n = trie[stack.back()];
+            stack.pop_back();
+
+            ids.insert(ids.end(), n.terminal.begin(), n.terminal.end());
+            stack.insert(stack.end(), n.children.begin(), n.children.end());
+        }
+    }
+
+    sort(ids.begin(), ids.end());
+}
+
+int HypTrie::best(EventView sequence, double *score) const
+{
+    int seqlen = sequence.length();
+
+    int bestId = -1;
+    double bestScore = 0.0;
+
+    //bodies that are a suffix of the sequence score their confidence; each node already knows its best
+    int node = 0;
+    int d = 0;
+
+    while (true)
+    {
+        int h = trie[node].best;
+
+        if (h != -1 && (confOf[h] > bestScore || (confOf[h] == bestScore && bestId != -1 && h < bestId)))
+        {
+            bestScore = confOf[h];
+            bestId = h;
+        }
+
+        if (d == seqlen)
+            break;
+
+        int next = child(node, sequence[seqlen - 1 - d]);
+
+        if (next == -1)
+            break;
+
+        node = next;
+        d++;
+    }
+
+    //longer bodies ending with the whole sequence score conf / body length * sequence length, as in hypMatch
+    if (seqlen > 0 && d == seqlen)
+    {
+        static thread_local vector<int> stack;
+        stack.assign(trie[node].children.begin(), trie[node].children.end());
+
+        while (!stack.empty())
+        {
+            const Node &n = trie[stack.back()];
+            stack.pop_back();
+
+            for (size_t i = 0; i < n.terminal.size(); i++)
+            {
+                int h = n.terminal[i];
+
+                double z = confOf[h];
+                z = z / n.depth * seqlen;
+
+                if (z > bestScore || (z == bestScore && bestId != -1 && h < bestId))
+                {
+                    bestScore = z;
+                    bestId = h;
+                }
+            }
+
+            stack.insert(stack.end(), n.children.begin(), n.children.end());
+        }
+    }
+
+    *score = bestScore;
+
+    return bestScore > 0.0 ? bestId : -1;
+}
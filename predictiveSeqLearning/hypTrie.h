@@ -0,0 +1,68 @@
+#ifndef HYPTRIE_H
+#define HYPTRIE_H
+
+#include <stdint.h>
+#include <unordered_map>
+#include "eventSeq.h"
+
+//hypothesis store for the exact kernel: a trie over the reversed hypothesis bodies.
+//grow only ever extends a parent body to the left, so walking the sequence backwards from its
+//last event visits every body that is a suffix of the sequence, one node per event.
+//a node keeps the hypotheses whose body ends there and the best of them by confidence.
+
+class HypTrie
+{
+public:
+    HypTrie();
+
+    void clear();
+
+    //hypotheses must be inserted in increasing id order
+    void insert(int id, EventView body, double conf);
+
+    //the confidence of a hypothesis changed (reward / punish)
+    void update(int id, double conf);
+
+    //every hypothesis that matches sequence exactly, in increasing id order: the bodies that are a suffix
+    //of the sequence, and the bodies longer than the sequence that end with all of it
+    void candidates(EventView sequence, vector<int> &ids) const;
+
+    //hypothesis with the highest hypMatch score for sequence (lowest id on ties), or -1 if none matches
+    int best(EventView sequence, double *score) const;
+
+    int size() const { return (int) nodeOf.size(); }
+
+    int nodes() const { return (int) trie.size(); }
+
+private:
+    typedef struct
+    {
+        vector<int> terminal; //hypotheses whose body ends at this node
+        vector<int> children;
+        int depth;            //body length of the terminal hypotheses
+        int best;             //terminal hypothesis with the highest confidence, -1 if none
+
+    } Node;
+
+    struct EdgeHash
+    {
+        size_t operator()(const pair<int, uint64_t> &e) const
+        {
+            return (size_t) (e.second * 0x9E3779B97F4A7C15ULL) ^ (size_t) e.first;
+        }
+    };
+
+    int child(int node, const EventItem &e) const;
+
+    void rescan(int node);
+
+    bool better(int a, int b) const;
+
+    vector<Node> trie;
+    unordered_map<pair<int, uint64_t>, int, EdgeHash> edges;
+
+    vector<int> nodeOf;
+    vector<double> confOf;
+};
+
+#endif
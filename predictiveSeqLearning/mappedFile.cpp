@@ -0,0 +1,66 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mappedFile.h"
+
+MappedFile::MappedFile()
+{
+    mapping = NULL;
+    length = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+void MappedFile::close()
+{
+    if (mapping != NULL)
+        munmap(mapping, length);
+
+    mapping = NULL;
+    length = 0;
+}
+
+bool MappedFile::open(const char *path, int access)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    if (st.st_size > 0)
+    {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        if (access == MAPPED_SEQUENTIAL)
+            madvise(data, st.st_size, MADV_SEQUENTIAL);
+        else if (access == MAPPED_RANDOM)
+            madvise(data, st.st_size, MADV_RANDOM);
+
+        mapping = data;
+        length = st.st_size;
+    }
+
+    ::close(fd);
+
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <stddef.h>
+
+//read-only mapping of a whole file. an empty file opens with size 0 and no data.
+
+//access patterns, passed to madvise
+#define MAPPED_NORMAL 0     //no advice, the kernel's default read-ahead
+#define MAPPED_SEQUENTIAL 1 //read front to back once: training data, logs, hypothesis files
+#define MAPPED_RANDOM 2     //read in place in no particular order
+
+class MappedFile
+{
+public:
+    MappedFile();
+
+    ~MappedFile();
+
+    //false if the file can't be opened or mapped. access is one of the MAPPED_ patterns
+    bool open(const char *path, int access);
+
+    void close();
+
+    const char *data() const { return (const char *) mapping; }
+
+    size_t size() const { return length; }
+
+private:
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    void *mapping;
+    size_t length;
+};
+
+#endif
@@ -0,0 +1,181 @@
+#include <ctype.h>
+#include <string.h>
+#include "pslConfig.h"
+
+#define PSLCONFIG_LINE 256
+
+static const char *keyNames[PSLCONFIG_KEYS] = { "kernel", "tolerance", "vtfactor", "capacity", "index", "store", "workers", "eviction" };
+
+//names of the values of the enumerated keys, indexed by value
+static const char *kernelNames[] = { "string", "native", "exact", NULL };
+static const char *indexNames[] = { "none", "exact", "quantized", NULL };
+static const char *storeNames[] = { "flat", "trie", NULL };
+static const char *evictionNames[] = { "none", "lru", "confsupport", "minsupport", NULL };
+
+static void lowercase(char *word)
+{
+    for (int i = 0; word[i] != '\0'; i++)
+    {
+        word[i] = tolower(word[i]);
+    }
+}
+
+//value of a name of the list, or of its number; -1 if it is neither
+static int namedValue(const char *word, const char **names)
+{
+    for (int i = 0; names[i] != NULL; i++)
+    {
+        if (strcmp(word, names[i]) == 0)
+            return i;
+    }
+
+    int count = 0;
+
+    while (names[count] != NULL)
+        count++;
+
+    char *end;
+    long v = strtol(word, &end, 10);
+
+    if (end == word || *end != '\0' || v < 0 || v >= count)
+        return -1;
+
+    return v;
+}
+
+//applies one line to config, false if it is not understood
+static bool readKey(const char *line, PslConfig &config)
+{
+    char key[PSLCONFIG_LINE];
+    char name[PSLCONFIG_LINE];
+    int a, b;
+    double f;
+
+    if (sscanf(line, " %s", key) != 1)
+        return false;
+
+    lowercase(key);
+
+    int k = 0;
+
+    while (k < PSLCONFIG_KEYS && strcmp(key, keyNames[k]) != 0)
+        k++;
+
+    switch (k)
+    {
+    case 0: //kernel
+        if (sscanf(line, " %*s %s", name) != 1)
+            return false;
+        lowercase(name);
+        config.matchKernel = namedValue(name, kernelNames);
+        return config.matchKernel >= 0;
+
+    case 1: //tolerance
+        if (sscanf(line, " %*s %d", &a) != 1 || a < 0)
+            return false;
+        config.matchTol = a;
+        return true;
+
+    case 2: //vtfactor
+        if (sscanf(line, " %*s %lf", &f) != 1 || f <= 0.0)
+            return false;
+        config.vtFactor = f;
+        return true;
+
+    case 3: //capacity
+        if (sscanf(line, " %*s %d", &a) != 1 || a < 0)
+            return false;
+        config.capacity = a;
+        return true;
+
+    case 4: //index, the quantum is optional
+        if (sscanf(line, " %*s %s", name) != 1)
+            return false;
+        lowercase(name);
+        config.hypIndexMode = namedValue(name, indexNames);
+        if (sscanf(line, " %*s %*s %d", &a) == 1)
+        {
+            if (a < 1)
+                return false;
+            config.quantum = a;
+        }
+        return config.hypIndexMode >= 0;
+
+    case 5: //store
+        if (sscanf(line, " %*s %s", name) != 1)
+            return false;
+        lowercase(name);
+        config.hypStore = namedValue(name, storeNames);
+        return config.hypStore >= 0;
+
+    case 6: //workers
+        if (sscanf(line, " %*s %d", &a) != 1 || a < 1)
+            return false;
+        config.workers = a;
+        return true;
+
+    case 7: //eviction, the limits are optional
+        if (sscanf(line, " %*s %s", name) != 1)
+            return false;
+        lowercase(name);
+        config.evictionPolicy = namedValue(name, evictionNames);
+        if (sscanf(line, " %*s %*s %d %d", &a, &b) == 2)
+        {
+            config.maxHypotheses = a;
+            config.minSupport = b;
+        }
+        return config.evictionPolicy >= 0;
+    }
+
+    return false;
+}
+
+int readPslConfig(const char *path, PslConfig &config)
+{
+    FILE *inFile = fopen(path, "r");
+
+    if (inFile == NULL)
+        return -1;
+
+    char line[PSLCONFIG_LINE];
+    int number = 0;
+    int status = 0;
+
+    while (fgets(line, sizeof(line), inFile) != NULL)
+    {
+        number++;
+
+        char first;
+
+        //blank lines and comments
+        if (sscanf(line, " %c", &first) != 1 || first == '#')
+            continue;
+
+        PslConfig read = config;
+
+        if (!readKey(line, read))
+        {
+            fprintf(stderr, "%s:%d: not a PSL configuration line: %s", path, number, line);
+            status = -1;
+            break;
+        }
+
+        config = read;
+    }
+
+    fclose(inFile);
+
+    return status;
+}
+
+void printPslConfig(const PslConfig &config, FILE *outFile)
+{
+    fprintf(outFile, "KERNEL    %s\n", kernelNames[config.matchKernel]);
+    fprintf(outFile, "TOLERANCE %d\n", config.matchTol);
+    fprintf(outFile, "VTFACTOR  %g\n", config.vtFactor);
+    fprintf(outFile, "CAPACITY  %d\n", config.capacity);
+    fprintf(outFile, "INDEX     %s %d\n", indexNames[config.hypIndexMode], config.quantum);
+    fprintf(outFile, "STORE     %s\n", storeNames[config.hypStore]);
+    fprintf(outFile, "WORKERS   %d\n", config.workers);
+    fprintf(outFile, "EVICTION  %s %d %d\n", evictionNames[config.evictionPolicy], config.maxHypotheses, config.minSupport);
+}
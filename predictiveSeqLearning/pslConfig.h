@@ -0,0 +1,30 @@
+#ifndef PSLCONFIG_H
+#define PSLCONFIG_H
+
+#include <stdio.h>
+#include "pslModel.h"
+
+//PSL parameters in the key-value style of applicationControl/robotConfig.txt: one key per line
+//followed by its values, keys in any case and any order, lines starting with # ignored.
+//keys that are not in the file keep the value they had.
+//
+//KERNEL     string | native | exact          matchKernel
+//TOLERANCE  2                                matchTol
+//VTFACTOR   2.0                              vtFactor
+//CAPACITY   1024                             capacity
+//INDEX      none | exact | quantized  1      hypIndexMode and quantum
+//STORE      flat | trie                      hypStore
+//WORKERS    1                                workers
+//EVICTION   none | lru | confsupport | minsupport  0  0
+//                                            evictionPolicy, maxHypotheses and minSupport
+
+#define PSLCONFIG_KEYS 8
+
+//reads the file into config. returns 0, or -1 if the file can't be read or a line is not understood
+//(the keys before that line are applied)
+int readPslConfig(const char *path, PslConfig &config);
+
+//writes config in the format readPslConfig reads
+void printPslConfig(const PslConfig &config, FILE *outFile);
+
+#endif
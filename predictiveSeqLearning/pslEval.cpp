@@ -0,0 +1,80 @@
+#include <time.h>
+#include "pslEval.h"
+#include "pslImplementation.h"
+
+double elapsed_ns(struct timespec end, struct timespec start)
+{
+    return (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+}
+
+void clearEvalResult(PslEvalResult &result)
+{
+    result.folds = 0;
+    result.predictions = 0;
+    result.covered = 0;
+    result.correct = 0;
+    result.trainEvents = 0;
+    result.trainNs = 0;
+}
+
+void addEvalResult(PslEvalResult &total, const PslEvalResult &fold)
+{
+    total.folds += fold.folds;
+    total.predictions += fold.predictions;
+    total.covered += fold.covered;
+    total.correct += fold.correct;
+    total.trainEvents += fold.trainEvents;
+    total.trainNs += fold.trainNs;
+}
+
+void evaluateDemo(const PslModel &model, EventView demo, PslEvalResult &result, vector<double> *latencies)
+{
+    struct timespec start, end;
+
+    for (int i = 1; i < demo.length(); i++)
+    {
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+        EventItem predicted = model.predict(demo.prefix(i));
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+        if (latencies != NULL)
+            latencies->push_back(elapsed_ns(end, start));
+
+        result.predictions++;
+
+        if (predicted.eventtype == 0)
+            continue;
+
+        result.covered++;
+
+        if (eventcompare(predicted, demo[i]) == 0)
+            result.correct++;
+    }
+}
+
+void evaluateHeldOut(const PslConfig &config, const vector<EventView> &demos, int held, PslEvalResult &result, vector<double> *latencies)
+{
+    PslModel model(config);
+
+    clearEvalResult(result);
+    result.folds = 1;
+
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    for (int i = 0; i < (int) demos.size(); i++)
+    {
+        if (i != held)
+        {
+            model.train(demos[i], 0, demos[i].length() - 1);
+            result.trainEvents += demos[i].length();
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    result.trainNs = elapsed_ns(end, start);
+
+    evaluateDemo(model, demos[held], result, latencies);
+}
@@ -0,0 +1,39 @@
+#ifndef PSLEVAL_H
+#define PSLEVAL_H
+
+#include <time.h>
+#include <vector>
+#include "eventSeq.h"
+#include "pslModel.h"
+
+using namespace std;
+
+//leave-one-demonstration-out evaluation: a model is trained on every demonstration but one, then asked
+//for every next event of the held-out demonstration given the events before it.
+
+typedef struct
+{
+    int folds;          //held-out demonstrations evaluated
+    long predictions;   //next events asked for
+    long covered;       //predictions that returned an event
+    long correct;       //predictions equal to the next event
+    long trainEvents;   //events of the training demonstrations
+    double trainNs;     //time spent training on them
+
+} PslEvalResult;
+
+void clearEvalResult(PslEvalResult &result);
+
+void addEvalResult(PslEvalResult &total, const PslEvalResult &fold);
+
+//trains a model of config on demos without demos[held] and scores the predictions of demos[held].
+//latencies, if not NULL, gets the time of every predict call in ns appended
+void evaluateHeldOut(const PslConfig &config, const vector<EventView> &demos, int held, PslEvalResult &result, vector<double> *latencies);
+
+//predictions of a trained model over every next event of demo, added to result
+void evaluateDemo(const PslModel &model, EventView demo, PslEvalResult &result, vector<double> *latencies);
+
+//ns between two clock_gettime readings
+double elapsed_ns(struct timespec end, struct timespec start);
+
+#endif
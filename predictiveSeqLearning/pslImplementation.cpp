@@ -1,38 +1,39 @@
 #include "pslImplementation.h"
 
-int hypothesisCount = 0;
-Hypothesis hypotheses[MAXHYP];
+//the model behind the free functions
+PslModel defaultModel;
+
+PslModel &getDefaultModel()
+{
+    return defaultModel;
+}
 
 void init()
 {
-    //initialize the hypotheses library.
-    //instantiate MAXHYP hypotheses and allocate memory for the body and head of each.
+    defaultModel.init();
+}
 
-    for (int i = 0; i < MAXHYP; i++)
-    {
-        hypotheses[i].hits = 1;
-        hypotheses[i].id = -1;
+int loadPslConfig(const char *path)
+{
+    PslConfig config = defaultModel.getConfig();
 
-        hypotheses[i].lhs = new Event_t();
-        hypotheses[i].rhs = new Event_t();
+    if (readPslConfig(path, config) < 0)
+        return -1;
 
-        hypotheses[i].lhs->eventtype = 0;
-        hypotheses[i].lhs->next = NULL;
+    defaultModel.setConfig(config);
 
-        hypotheses[i].rhs->eventtype = 0;
-        hypotheses[i].rhs->next = NULL;
-    }
+    return 0;
 }
 
 void free_hyp()
 {
-    for (int i = 0; i < hypothesisCount; i++)
-    {
-        free_event_seq(hypotheses[i].lhs);
-        delete hypotheses[i].rhs;
-    }
+    defaultModel.free_hyp();
 }
 
+int getHypothesisCount()
+{
+    return defaultModel.size();
+}
 
 Hypothesis newHyp()
 {
@@ -41,12 +42,265 @@ Hypothesis newHyp()
     hyp.id = -1;
     hyp.hits = 1;
     hyp.misses = 0;
-    hyp.lhs = new Event_t();
-    hyp.rhs = new Event_t();
+    hyp.rhs = EventItem(); //all zero, as the no-match event of a failed prediction
 
     return hyp;
 }
 
+void print_event(const EventItem &current, FILE * outFile)
+{
+    if (current.eventtype == 1)
+        fprintf(outFile, "%d %d %d %d %d \n", current.event.action.deltaX, current.event.action.deltaY, current.event.action.deltaZ, current.event.action.deltaangle, current.event.action.grasp );
+    else
+        fprintf(outFile, "%d %d %d %d %d\n", current.event.observation.diffX, current.event.observation.diffY, current.event.observation.diffZ, current.event.observation.diffangle, current.event.observation.grasp ); 
+}
+
+void print_list(EventView sequence)
+{
+    print_list(sequence, stdout);
+}
+
+void print_list(EventView sequence, FILE * outFile)
+{
+    for (int i = 0; i < sequence.length(); i++)
+    {
+        print_event(sequence[i], outFile);
+    }
+}
+
+void push(EventSeq &sequence, EventUnion val, int eventtype)
+{
+    sequence.push(val, eventtype);
+}
+
+int getEventSeqLen(const EventSeq &sequence)
+{
+    return sequence.length();
+}
+
+EventSeq subsequence(const EventSeq &sequence, int startIndex, int stopIndex)
+{
+    EventSeq sub;
+
+    if ((stopIndex > startIndex) && (startIndex >= 0) && (sequence.length() >= stopIndex))
+    {
+        sub.reserve(stopIndex - startIndex);
+
+        for (int i = startIndex; i < stopIndex; i++)
+        {   
+            sub.push(sequence[i]);
+        }
+    }
+
+    return sub;
+}
+
+int getVtFactor(const Hypothesis &hyp)
+{
+    return defaultModel.getVtFactor(hyp);
+}
+
+Hypothesis grow(EventView sequence, const Hypothesis &parent)
+{
+    return defaultModel.grow(sequence, parent);
+}
+
+Hypothesis grow_sub(EventView sequence, const EventItem &parent)
+{
+    return defaultModel.grow_sub(sequence, parent);
+}
+
+double conf(int hypIndex)
+{
+    return defaultModel.conf(hypIndex);
+}
+
+int support(int hypIndex)
+{
+    return defaultModel.support(hypIndex);
+}
+
+void reward(int hypIndex, int value)
+{
+    defaultModel.reward(hypIndex, value);
+}
+
+void punish(int hypIndex, int value)
+{
+    defaultModel.punish(hypIndex, value);
+}
+
+void setMatchKernel(int kernel)
+{
+    defaultModel.setMatchKernel(kernel);
+}
+
+int getMatchKernel()
+{
+    return defaultModel.getMatchKernel();
+}
+
+void setHypIndexMode(int mode, int quantum)
+{
+    defaultModel.setHypIndexMode(mode, quantum);
+}
+
+int getHypIndexMode()
+{
+    return defaultModel.getHypIndexMode();
+}
+
+void setHypStore(int store)
+{
+    defaultModel.setHypStore(store);
+}
+
+int getHypStore()
+{
+    return defaultModel.getHypStore();
+}
+
+void setWorkerCount(int workers)
+{
+    defaultModel.setWorkerCount(workers);
+}
+
+int getWorkerCount()
+{
+    return defaultModel.getWorkerCount();
+}
+
+int hyp_approxmatch(EventView a, EventView b)
+{
+    return defaultModel.approxmatch(a, b);
+}
+
+int hyp_approxmatch_native(EventView a, EventView b)
+{
+    return hyp_approxmatch_native(a, b, MATCHTOL);
+}
+
+int hyp_approxmatch_native(EventView a, EventView b, int k)
+{
+    return eventSeqDistance(a, b, defaultEventCost, k) > k ? -1 : 0;
+}
+
+int hyp_approxmatch_exact(EventView a, EventView b)
+{
+    if (a.length() != b.length())
+        return -1;
+
+    for (int i = a.length() - 1; i >= 0; i--)
+    {
+        if (eventcompare(a[i], b[i]) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int hyp_approxmatch_string(EventView a, EventView b)
+{
+    return hyp_approxmatch_string(a, b, MATCHTOL);
+}
+
+int hyp_approxmatch_string(EventView a, EventView b, int k)
+{
+
+    //a - source, b - target. the texts are built in per-thread buffers that keep their capacity
+    static thread_local string _a, _b;
+
+    _a.clear();
+    _b.clear();
+
+    appendEventText(_a, a);
+    appendEventText(_b, b);
+
+    return approxmatch(_a, _b, k, 1);
+}
+
+double hypMatch(int hypIndex, EventView sequence)
+{
+    return defaultModel.hypMatch(hypIndex, sequence);
+}
+
+void hypCandidates(EventView sequence, vector<int> &ids)
+{
+    defaultModel.hypCandidates(sequence, ids);
+}
+
+Hypothesis selectHyp(EventView seq)
+{
+    return defaultModel.selectHyp(seq);
+}
+
+void getConfScores(EventView sequence, double hs[])
+{    
+    defaultModel.getConfScores(sequence, hs);
+}
+
+void clearHypotheses()
+{
+    defaultModel.clearHypotheses();
+}
+
+int eventcompare(const EventItem &a, const EventItem &b)
+{
+    if (a.eventtype != b.eventtype)
+        return -1;
+    if (a.eventtype == 1)
+    {
+        if (a.event.action.deltaangle == b.event.action.deltaangle &&
+            a.event.action.deltaX == b.event.action.deltaX && a.event.action.deltaY == b.event.action.deltaY &&
+            a.event.action.deltaZ == b.event.action.deltaZ && a.event.action.grasp == b.event.action.grasp)
+            return 0;
+        else
+            return -1;
+    }
+    else
+    {
+        if (a.event.observation.diffangle == b.event.observation.diffangle &&
+            a.event.observation.diffX == b.event.observation.diffX && a.event.observation.diffY == b.event.observation.diffY &&
+            a.event.observation.diffZ == b.event.observation.diffZ && a.event.observation.grasp == b.event.observation.grasp) 
+            return 0;
+        else
+            return -1;
+    }
+}
+
+void train(EventView sequence, int startIndex, int stopIndex)
+{
+    defaultModel.train(sequence, startIndex, stopIndex);
+}
+
+EventItem predict(EventView seq)
+{
+    return defaultModel.predict(seq);
+}
+
+void predictTopK(EventView seq, int k, vector<Prediction> &out)
+{
+    defaultModel.predictTopK(seq, k, out);
+}
+
+
+void print_hypotheses()
+{
+    print_hypotheses(stdout);
+}
+
+void print_hypotheses(FILE * outFile)
+{
+    defaultModel.print_hypotheses(outFile);
+}
+
+int load_hypotheses(FILE * inFile)
+{
+    return defaultModel.load_hypotheses(inFile);
+}
+
+//linked-list adapters
+
 void print_list(Event_t *head)
 {
 
@@ -182,436 +436,58 @@ Event_t * subsequence(Event_t *sequence, int startIndex, int stopIndex)
     return sub;
 }
 
-int getVtFactor(Hypothesis hyp)
-{
-    int l = getEventSeqLen(hyp.lhs);
-    int f = floor(l * VTFACTOR);
-
-    return max(l + 1, f);
-}
-
 Hypothesis grow(Event_t *sequence, Hypothesis parent)
 {
-    int slen = getEventSeqLen(sequence);
-    int vtFactor;
-    if(getVtFactor(parent) > slen )
-         vtFactor = slen;
-    else 
-         vtFactor = getVtFactor(parent);
-
-    hypotheses[hypothesisCount].lhs = subsequence(sequence, slen - vtFactor, slen);
-
-    hypotheses[hypothesisCount].rhs = subsequence(parent.rhs, 0, 1);
-    
-
-    // print_list(hypotheses[hypothesisCount].lhs);
-    // printf("->");
-    // print_list(hypotheses[hypothesisCount].rhs);
-
-    hypotheses[hypothesisCount].id = hypothesisCount;
-
-    hypothesisCount += 1;
-    return hypotheses[hypothesisCount - 1];
+    return grow(EventSeq(sequence), parent);
 }
 
 Hypothesis grow_sub(Event_t *sequence, Event_t *parent)
 {
-    //if PSL failed to predict
-
-    int slen = getEventSeqLen(sequence);
-
-    Hypothesis h = newHyp();
-
-    h.lhs = subsequence(sequence, slen - 1, slen); //add the last event sequence
-    h.rhs = parent;
-
-    // print_list(h.lhs);
-    // printf("->");
-    // print_list(h.rhs);
-
-    hypotheses[hypothesisCount] = h;
-    hypotheses[hypothesisCount].id = hypothesisCount;
-
-    hypothesisCount += 1;
-    return hypotheses[hypothesisCount - 1];
-}
-
-double conf(int hypIndex)
-{
-    double conf = (double) (getEventSeqLen(hypotheses[hypIndex].lhs) * hypotheses[hypIndex].hits) / (double)(hypotheses[hypIndex].hits + hypotheses[hypIndex].misses);
-    
-    // printf("%d %f \n", hypIndex, conf);
-
-    return conf;
-}
-
-int support(int hypIndex)
-{
-    return hypotheses[hypIndex].misses + hypotheses[hypIndex].hits;
-}
-
-void reward(int hypIndex, int value)
-{
-    if (value)
-    {
-        hypotheses[hypIndex].hits += value;
-    }
-}
-
-void punish(int hypIndex, int value)
-{
-    //punish the hypothesis by increasing the value of its misses
-
-    if (value)
-    {
-        hypotheses[hypIndex].misses += value;
-    }
+    return grow_sub(EventSeq(sequence), makeEventItem(parent->event, parent->eventtype));
 }
 
 int hyp_approxmatch(Event_t *a, Event_t *b)
 {
-
-    //a - source, b - target
-    string _a, _b;
-
-    Event_t * current = a;
-
-    while (current != NULL)
-    {
-        if (current->eventtype == 1)
-        {
-            _a = _a + to_string((int)current->event.action.deltaX);
-            _a = _a + to_string((int)current->event.action.deltaY);
-            _a = _a + to_string((int)current->event.action.deltaZ);
-            _a = _a + to_string((int)current->event.action.deltaangle);
-            _a = _a + to_string((int)current->event.action.grasp);
-
-            // _a.push_back('1');
-            
-
-        }
-        else if (current->eventtype == 2)
-        {
-            _a = _a + to_string((int)current->event.observation.diffX);
-            _a = _a + to_string((int)current->event.observation.diffY);
-            _a = _a + to_string((int)current->event.observation.diffZ);
-            _a = _a + to_string((int)current->event.observation.diffangle);
-            _a = _a + to_string((int)current->event.observation.grasp);
-            
-            // _a.push_back('2');
-            
-        }
-
-        current = current->next;
-    }
-
-    current = b;
-
-    while (current != NULL)
-    {
-        if (current->eventtype == 1)
-        {
-            _b = _b + to_string((int)current->event.action.deltaX);
-            _b = _b + to_string((int)current->event.action.deltaY);
-            _b = _b + to_string((int)current->event.action.deltaZ);
-            _b = _b + to_string((int)current->event.action.deltaangle);
-            _b = _b + to_string((int)current->event.action.grasp);
-
-            // _b.push_back('1');
-            
-        }
-        else if (current->eventtype == 2)
-        {
-            _b = _b + to_string((int)current->event.observation.diffX);
-            _b = _b + to_string((int)current->event.observation.diffY);
-            _b = _b + to_string((int)current->event.observation.diffZ);
-            _b = _b + to_string((int)current->event.observation.diffangle);
-            _b = _b + to_string((int)current->event.observation.grasp);
-
-            // _b.push_back('2');          
-
-        }
-
-        current = current->next;
-    }
-
-    int match = approxmatch(_a, _b, 2, 1);
-
-    free_event_seq(current);    
-
-    return match;
-    
+    return hyp_approxmatch(EventSeq(a), EventSeq(b));
 }
 
 double hypMatch(int hypIndex, Event_t *sequence)
 {
-    //match the lhs of the hypothesis with a given sequence returning a certain confidence score
-    //adjusted for the length of the both sequences
-
-    int seqlen = getEventSeqLen(sequence);
-    int hypLhsLen = getEventSeqLen(hypotheses[hypIndex].lhs);
-
-    if (sequence)
-    {
-        int diff = hypLhsLen - seqlen;
-
-        if(hypLhsLen == 0)
-            return conf(hypIndex);
-        
-        else if(seqlen < hypLhsLen)
-        {
-
-                Event_t * sub = subsequence(hypotheses[hypIndex].lhs, diff, hypLhsLen );
-                if(hyp_approxmatch(sub , sequence) == 0){
-
-                    double z = conf(hypIndex);
-                    z = z / hypLhsLen * seqlen;
-
-                    free_event_seq(sub);
-                    return z;
-                }
-                
-        }
-        
-        else {
-
-             Event_t * sub = subsequence(sequence, seqlen - hypLhsLen, seqlen );
-
-             if(hyp_approxmatch(sub, hypotheses[hypIndex].lhs) == 0)
-             {
-                return conf(hypIndex);
-            }
-            else {            
-                return 0.0;
-             }
-
-            free_event_seq(sub); //suspect 
-           
-        }
-
-    }
-
-    else
+    if (!sequence)
         return 0.0;
 
-    return 0.0;
+    return hypMatch(hypIndex, EventSeq(sequence));
 }
 
 Hypothesis selectHyp(Event_t *seq)
 {
-    double * scores = new double[hypothesisCount];
-    
-    for (int i = 0; i < hypothesisCount; i++)
-    {
-        double score = hypMatch(i, seq);
-        scores[i] = score;
-    }
-    int max = 0;
-    int index = 0;
-    for (int i = 0; i < hypothesisCount; i++)
-    {
-        if (max < scores[i])
-        {
-            max = scores[i];
-            index = i;
-        }
-    }
-    Hypothesis nullHyp = newHyp();
-
-    // if(scores[index] > 0.0) printf("| %d | \n", index);
-
-    return scores[index] > 0.0 ? hypotheses[index] : nullHyp;
+    return selectHyp(EventSeq(seq));
 }
 
 void getConfScores(Event_t *sequence, double hs[])
-{    
-    if (hypothesisCount == 0)
-        return;
-
-    for (int i = 0; i < hypothesisCount; i++)
-    {
-        double a = hypMatch(i, sequence);
-        hs[i] = a;
-    }
-
-}
-
-void clearHypotheses()
 {
-    for (size_t i = 0; i < MAXHYP; i++)
-    {
-        hypotheses[i].id = -1;
-
-        for (size_t j = 0; j < (size_t) getEventSeqLen(hypotheses[i].lhs); j++)
-        {
-            hypotheses[i].lhs[j].eventtype = 0;
-        }
-
-        hypotheses[i].rhs->eventtype = 0;
-        hypotheses[i].misses = 0;
-        hypotheses[i].hits = 1;
-    }
+    getConfScores(EventSeq(sequence), hs);
 }
 
 int eventcompare(Event_t *a, Event_t *b)
 {
-    if (a->eventtype != b->eventtype)
-        return -1;
-    if (a->eventtype == 1)
-    {
-        if (a->event.action.deltaangle == b->event.action.deltaangle &&
-            a->event.action.deltaX == b->event.action.deltaX && a->event.action.deltaY == b->event.action.deltaY &&
-            a->event.action.deltaZ == b->event.action.deltaZ && a->event.action.grasp == b->event.action.grasp)
-            return 0;
-        else
-            return -1;
-    }
-    else
-    {
-        if (a->event.observation.diffangle == b->event.observation.diffangle &&
-            a->event.observation.diffX == b->event.observation.diffX && a->event.observation.diffY == b->event.observation.diffY &&
-            a->event.observation.diffZ == b->event.observation.diffZ && a->event.observation.grasp == b->event.observation.grasp) 
-            return 0;
-        else
-            return -1;
-    }
+    return eventcompare(makeEventItem(a->event, a->eventtype), makeEventItem(b->event, b->eventtype));
 }
 
 void train(Event_t *sequence, int startIndex, int stopIndex)
 {
-    // init();
-    int seqlen = getEventSeqLen(sequence);
-
-    if(seqlen < 2) return;
-
-    if (seqlen <= stopIndex || startIndex >= seqlen || startIndex > stopIndex)
-        return;
-
-    if(startIndex == 0) startIndex = 1;
-
-    for (int i = startIndex; i < stopIndex + 1; i++)
-    {
-        Event_t * sub = subsequence(sequence, 0, i);
-        Event_t * t = subsequence(sequence, i, i+1);
-
-        // printf("%s", "sub: \n");
-
-        // print_list(sub);
-
-        double * hs = new double[hypothesisCount];
-
-        // printf("%s", "scores (hyps => sub): ");
-
-        getConfScores(sub, hs); //gets a confidence score for every hypothesis
-
-        // for (int j = 0; j < hypothesisCount; j++)
-        // {
-        //     printf("hs[%d]: %f ", j, hs[j]);
-        // }
-        // printf("\n");
-
-        Hypothesis maxh = newHyp();
-        
-        double maxc = -1.0;
-        bool correct = false;
-        Hypothesis bestCorrect = newHyp();
- 
-        for (int j = 0; j < hypothesisCount; j++)
-        {
-            double conf = hs[j];
-
-            // printf("conf: %f\n", conf);
-
-            if (conf > 0.0)
-            {
-                Hypothesis hyp = hypotheses[j];
-
-                if (maxc < conf)
-                {
-                    maxc = conf;
-                    maxh = hyp;
-                }
-
-                if (eventcompare(hyp.rhs, t) == 0)
-                {
-                    reward(j, 1);
-                    // printf("reward(%d)\n" ,j+1);
-
-                    if (bestCorrect.id == -1 || getEventSeqLen(bestCorrect.lhs) < getEventSeqLen(hyp.lhs))
-                    {
-                        bestCorrect = hyp;
-                    }
-                }
-            }
-        }
-
-        //if the rhs sugessted doesn't match the next event in the sequence, punish the hypothesis
-        
-        correct = (maxh.id != -1) && (eventcompare(maxh.rhs, t) == 0);
-
-        if(maxh.id != -1 && !correct)
-        {
-            punish(maxh.id, 1);
-            // printf("punish(%d)\n", maxh.id+1);
-        }
-
-        //psl learns only on failure
-        //hypothesis library is updated in grow
-        
-        if(!correct)
-        {
-            if (bestCorrect.id == -1)
-            grow_sub(sub, t);
-            else
-            grow(sub, bestCorrect);            
-        }
-
-        free_event_seq(sub);       
-    }
-
-    // print_hypotheses();
-
+    train(EventSeq(sequence), startIndex, stopIndex);
 }
 
 Event_t *predict(Event_t *seq)
 {
-    Hypothesis h = selectHyp(seq);
-    return h.rhs;
-}
-
+    static Event_t prediction;
 
-void print_hypotheses()
-{
-    for(int i=0; i< MAXHYP; i++)
-    {
-        Hypothesis hyp = hypotheses[i];
-        if(hyp.id == -1) break;
+    EventItem item = predict(EventSeq(seq));
 
-        print_list(hyp.lhs);
+    prediction.event = item.event;
+    prediction.eventtype = item.eventtype;
+    prediction.next = NULL;
 
-        printf("%s\n", "->");
-
-        print_list(hyp.rhs);
-
-        printf("%s hits %d, misses %d \n", ":", hyp.hits, hyp.misses);
-        
-    }
-}
-
-void print_hypotheses(FILE * outFile)
-{
-    for(int i=0; i< MAXHYP; i++)
-    {
-        Hypothesis hyp = hypotheses[i];
-        if(hyp.id == -1) break;
-
-        print_list(hyp.lhs, outFile);
-
-        fprintf(outFile, "%s\n", "->");
-
-        print_list(hyp.rhs, outFile);
-
-        fprintf(outFile, "%s hits %d, misses %d \n", ":", hyp.hits, hyp.misses);
-        
-    }
+    return &prediction;
 }
\ No newline at end of file
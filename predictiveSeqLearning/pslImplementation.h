@@ -5,13 +5,19 @@
 #include <math.h>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 #include "approxmatch.h"
-
-
-#define EVENTLEN 270
-#define MAXEVENT 20000
-#define MAXHYP 10000
-#define VTFACTOR 2.0
+#include "eventSeq.h"
+#include "eventDistance.h"
+#include "eventText.h"
+#include "pslModel.h"
+#include "pslSession.h"
+#include "pslSnapshot.h"
+#include "hypParser.h"
+#include "trainingData.h"
+#include "demoLog.h"
+#include "trainingCorpus.h"
+#include "pslConfig.h"
 
 // #define NULL ((void *)0)
 
@@ -21,64 +27,124 @@
 
 using namespace std;
 
-//lhs represents the hypothesis body and rhs represents the head in PSL nomenclature
-//misses and hits are used to calculate the support and confidence of an hypothesis
-//id = 0 means the hypothesis is NULL (or empty). as C doesn't support assigning NULL to an hypothesis.
+//the free functions below run on one default model, see pslModel.h for separate models
 
-typedef struct
-{
-    signed char diffX;
-    signed char diffY;
-    signed char diffZ;
-    signed char diffangle;
-    signed char grasp;    
+PslModel &getDefaultModel();
+
+void init();
 
-} Observation;
+//applies a readPslConfig file to the default model, keys missing from it keep their current values.
+//returns -1 if the file can't be read or has a line that is not understood
+int loadPslConfig(const char *path);
 
-typedef struct
-{
-    signed char deltaX;
-    signed char deltaY;
-    signed char deltaZ;
-    signed char deltaangle;
-    signed char grasp;
+Hypothesis newHyp();
 
-} Action;
+int getHypothesisCount();
 
-typedef union {
-    Observation observation;
-    Action action;
+//PSL API over contiguous event sequences.
+//functions taking an EventView accept an EventSeq directly and never copy the events.
 
-} EventUnion;
+void print_list(EventView sequence);
 
-//eventtype 1 - Action, 2 - Observation, 0 - notdefined
+void print_list(EventView sequence, FILE * outFile);
 
-typedef struct Event
-{
-    EventUnion event;
-    int eventtype;
-    struct Event *next;
+void print_event(const EventItem &current, FILE * outFile);
 
-} Event_t;
+void push(EventSeq &sequence, EventUnion val, int eventtype);
 
-typedef struct
-{
+int getEventSeqLen(const EventSeq &sequence);
 
-    int id;
-    Event_t *lhs;
-    Event_t *rhs;
-    int misses;
-    int hits;
+EventSeq subsequence(const EventSeq &sequence, int startIndex, int stopIndex);
 
-} Hypothesis;
+int getVtFactor(const Hypothesis &hyp);
 
+Hypothesis grow(EventView sequence, const Hypothesis &parent);
 
-void init();
+Hypothesis grow_sub(EventView sequence, const EventItem &parent);
 
-Hypothesis newHyp();
+double conf(int hypIndex);
+
+int support(int hypIndex);
+
+void reward(int hypIndex, int value);
+
+void punish(int hypIndex, int value);
+
+//selects the kernel used by hyp_approxmatch (MATCH_STRING, MATCH_NATIVE or MATCH_EXACT)
+void setMatchKernel(int kernel);
+
+int getMatchKernel();
+
+//selects how the hypotheses scored for a sequence are found (HYPINDEX_NONE, HYPINDEX_EXACT or HYPINDEX_QUANTIZED).
+//HYPINDEX_EXACT (default) gives the same results as scoring every hypothesis; the string kernel always scores all of them.
+//quantum is the bucket width of the event fields in HYPINDEX_QUANTIZED mode.
+void setHypIndexMode(int mode, int quantum);
+
+int getHypIndexMode();
+
+//selects the hypothesis store (HYPSTORE_FLAT or HYPSTORE_TRIE), rebuilt from the current library.
+//the trie is only walked by the exact kernel, the other kernels keep using the flat store.
+//train gives the same library with both stores. predict through the trie returns the highest score
+//(lowest id on ties) from the best hypothesis kept at each node.
+void setHypStore(int store);
+
+int getHypStore();
+
+//number of threads scoring hypotheses in train, selectHyp and getConfScores, the caller included (default 1).
+//the results do not depend on it: scores are reduced in hypothesis id order.
+void setWorkerCount(int workers);
+
+int getWorkerCount();
+
+//ids of the hypotheses scored for sequence under the current index mode and kernel, in increasing order
+void hypCandidates(EventView sequence, vector<int> &ids);
+
+int hyp_approxmatch(EventView a, EventView b);
+
+//kernels with k = MATCHTOL, and with an explicit k
+int hyp_approxmatch_string(EventView a, EventView b);
+
+int hyp_approxmatch_string(EventView a, EventView b, int k);
+
+int hyp_approxmatch_native(EventView a, EventView b);
+
+int hyp_approxmatch_native(EventView a, EventView b, int k);
+
+int hyp_approxmatch_exact(EventView a, EventView b);
+
+double hypMatch(int hypIndex, EventView sequence);
+
+Hypothesis selectHyp(EventView seq);
+
+void getConfScores(EventView sequence, double hs[]);
+
+void clearHypotheses();
+
+int eventcompare(const EventItem &a, const EventItem &b);
+
+void train(EventView sequence, int startIndex, int stopIndex);
+
+//returns an item with eventtype 0 if no hypothesis matches
+EventItem predict(EventView seq);
+
+//the k best predictions with their confidence, hypothesis and support, best first (see PslModel::predictTopK)
+void predictTopK(EventView seq, int k, vector<Prediction> &out);
+
+void free_hyp();
+
+void print_hypotheses();
+
+void print_hypotheses(FILE * outFile);
+
+//reads hypotheses written by print_hypotheses into the default model, see PslModel::load_hypotheses
+int load_hypotheses(FILE * inFile);
+
+//linked-list entry points, kept as thin adapters over the EventSeq API
 
 void print_list(Event_t *head);
 
+void print_list(Event_t *head, FILE * outFile);
+
 void push(Event_t * head, EventUnion val, int eventtype);
 
 int getEventSeqLen(Event_t *sequence);
@@ -87,20 +153,10 @@ Event_t * get_by_index(Event_t *head, int n);
 
 Event_t * subsequence(Event_t *sequence, int startIndex, int stopIndex);
 
-int getVtFactor(Hypothesis hyp);
-
 Hypothesis grow(Event_t *sequence, Hypothesis parent);
 
 Hypothesis grow_sub(Event_t *sequence, Event_t *parent);
 
-double conf(int hypIndex);
-
-int support(int hypIndex);
-
-void reward(int hypIndex, int value);
-
-void punish(int hypIndex, int value);
-
 int hyp_approxmatch(Event_t *a, Event_t *b);
 
 double hypMatch(int hypIndex, Event_t *sequence);
@@ -109,18 +165,11 @@ Hypothesis selectHyp(Event_t *seq);
 
 void getConfScores(Event_t *sequence, double hs[]);
 
-void clearHypotheses();
-
 int eventcompare(Event_t *a, Event_t *b);
 
 void train(Event_t *sequence, int startIndex, int stopIndex);
 
+//the returned event is owned by PSL and overwritten by the next call
 Event_t *predict(Event_t *seq);
 
-void free_hyp();
-
 void free_event_seq(Event_t * head);
-
-void print_hypotheses();
-
-void print_hypotheses(FILE * outFile);
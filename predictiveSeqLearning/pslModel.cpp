@@ -0,0 +1,1013 @@
+#include <string.h>
+#include "pslImplementation.h"
+
+PslConfig defaultPslConfig()
+{
+    PslConfig config;
+
+    config.vtFactor = VTFACTOR;
+    config.matchKernel = MATCH_NATIVE;
+    config.matchTol = MATCHTOL;
+    config.capacity = HYPCAPACITY;
+    config.hypIndexMode = HYPINDEX_EXACT;
+    config.quantum = 1;
+    config.hypStore = HYPSTORE_FLAT;
+    config.workers = 1;
+    config.evictionPolicy = EVICT_NONE;
+    config.maxHypotheses = 0;
+    config.minSupport = 0;
+
+    return config;
+}
+
+PslModel::PslModel()
+{
+    config = defaultPslConfig();
+
+    hypIndex.configure(config.hypIndexMode, config.quantum);
+
+    init();
+}
+
+PslModel::PslModel(const PslConfig &config)
+{
+    this->config = config;
+
+    hypIndex.configure(config.hypIndexMode, config.quantum);
+    scorePool.resize(config.workers);
+
+    init();
+}
+
+void PslModel::init()
+{
+    //initialize the hypotheses library.
+    //only the per-hypothesis arrays are reserved, bodies go to the event pool as they are learned.
+
+    clearHypotheses();
+
+    library.reserve(config.capacity, 0);
+}
+
+void PslModel::clearHypotheses()
+{
+    library.clear();
+    hypIndex.clear();
+    hypTrie.clear();
+    bodyText.clear();
+
+    nextId = 0;
+    longestBody = 0;
+    step = 0;
+    lowSupport = 0;
+    evicted = 0;
+    compactions = 0;
+}
+
+void PslModel::free_hyp()
+{
+    clearHypotheses();
+    library.release();
+}
+
+void PslModel::setConfig(const PslConfig &config)
+{
+    this->config.capacity = config.capacity;
+    this->config.matchKernel = config.matchKernel;
+    this->config.hypIndexMode = config.hypIndexMode;
+    this->config.quantum = config.quantum;
+    this->config.hypStore = config.hypStore;
+
+    setVtFactor(config.vtFactor);
+    setMatchTolerance(config.matchTol);
+    setWorkerCount(config.workers);
+
+    //index, trie and body text for the new kernel and lookup settings in one pass
+    rebuildLookup();
+
+    setEvictionPolicy(config.evictionPolicy, config.maxHypotheses, config.minSupport);
+}
+
+void PslModel::setMatchKernel(int kernel)
+{
+    config.matchKernel = kernel;
+
+    rebuildBodyText();
+}
+
+void PslModel::setMatchTolerance(int k)
+{
+    config.matchTol = k;
+}
+
+void PslModel::setVtFactor(double vtFactor)
+{
+    config.vtFactor = vtFactor;
+}
+
+void PslModel::setHypIndexMode(int mode, int quantum)
+{
+    config.hypIndexMode = mode;
+    config.quantum = quantum;
+
+    rebuildLookup();
+}
+
+void PslModel::setHypStore(int store)
+{
+    config.hypStore = store;
+
+    rebuildLookup();
+}
+
+void PslModel::rebuildLookup()
+{
+    hypIndex.configure(config.hypIndexMode, config.quantum);
+    hypTrie.clear();
+    longestBody = 0;
+
+    for (int i = 0; i < library.size(); i++)
+    {
+        hypIndex.add(i, library.body(i));
+
+        if (config.hypStore == HYPSTORE_TRIE)
+            hypTrie.insert(i, library.body(i), conf(i));
+
+        longestBody = max(longestBody, library.bodyLength(i));
+    }
+
+    rebuildBodyText();
+}
+
+void PslModel::rebuildBodyText()
+{
+    bodyText.clear();
+
+    if (config.matchKernel != MATCH_STRING)
+        return;
+
+    //the pool holds the bodies one after the other in slot order
+    for (int i = 0; i < library.size(); i++)
+    {
+        bodyText.append(library.body(i));
+    }
+}
+
+void PslModel::setWorkerCount(int workers)
+{
+    config.workers = workers < 1 ? 1 : workers;
+    scorePool.resize(config.workers);
+}
+
+void PslModel::setEvictionPolicy(int policy, int maxHypotheses, int minSupport)
+{
+    config.evictionPolicy = policy;
+    config.maxHypotheses = maxHypotheses;
+    config.minSupport = minSupport;
+
+    countLowSupport();
+    evict();
+}
+
+PslStats PslModel::getStats() const
+{
+    PslStats stats;
+
+    stats.live = library.size();
+    stats.evicted = evicted;
+    stats.compactions = compactions;
+    stats.bytes = library.memoryUsage();
+
+    return stats;
+}
+
+double PslModel::evictionPriority(int slot) const
+{
+    if (config.evictionPolicy == EVICT_LRU)
+        return library.lastMatch(slot);
+
+    if (config.evictionPolicy == EVICT_CONFSUPPORT)
+        return conf(slot) * support(slot);
+
+    //EVICT_MINSUPPORT: support first, conf() (below the body length + 1) breaks the ties
+    return support(slot) * (library.bodyLength(slot) + 1.0) + conf(slot);
+}
+
+void PslModel::countLowSupport()
+{
+    lowSupport = 0;
+
+    for (int slot = 0; slot < library.size(); slot++)
+    {
+        if (support(slot) < config.minSupport)
+            lowSupport++;
+    }
+}
+
+void PslModel::evict()
+{
+    int n = library.size();
+
+    if (config.evictionPolicy == EVICT_NONE || config.maxHypotheses <= 0 || n <= config.maxHypotheses)
+        return;
+
+    //nothing can go: skip the scan until a hypothesis below minSupport is learned
+    if (config.evictionPolicy == EVICT_MINSUPPORT && lowSupport == 0)
+        return;
+
+    int target = config.maxHypotheses - config.maxHypotheses / EVICTSLACK;
+
+    vector<pair<double, int> > order;
+    order.reserve(n);
+
+    for (int slot = 0; slot < n; slot++)
+    {
+        if (config.evictionPolicy == EVICT_MINSUPPORT && support(slot) >= config.minSupport)
+            continue;
+
+        order.push_back(make_pair(evictionPriority(slot), slot));
+    }
+
+    int count = min((int) order.size(), n - target);
+
+    if (count <= 0)
+        return;
+
+    //lowest priority first, older slots first on ties
+    nth_element(order.begin(), order.begin() + (count - 1), order.end());
+
+    vector<char> keep(n, 1);
+
+    for (int i = 0; i < count; i++)
+    {
+        keep[order[i].second] = 0;
+    }
+
+    //retained hypotheses keep their order, so ties in selectHyp resolve as before
+    library.compact(keep);
+    rebuildLookup();
+    countLowSupport();
+
+    evicted += count;
+    compactions++;
+}
+
+Hypothesis PslModel::hypothesis(int id) const
+{
+    Hypothesis hyp;
+
+    hyp.id = library.id(id);
+    hyp.lhs.assign(library.body(id));
+    hyp.rhs = library.rhs(id);
+    hyp.hits = library.hits(id);
+    hyp.misses = library.misses(id);
+
+    return hyp;
+}
+
+int PslModel::getVtFactor(const Hypothesis &hyp) const
+{
+    int l = hyp.lhs.length();
+    int f = floor(l * config.vtFactor);
+
+    return max(l + 1, f);
+}
+
+//adds a new hypothesis to the library and the lookup structures
+int PslModel::addHypothesis(EventView body, const EventItem &rhs)
+{
+    return restoreHypothesis(body, rhs, 1, 0);
+}
+
+int PslModel::restoreHypothesis(EventView body, const EventItem &rhs, int hits, int misses)
+{
+    int id = library.add(nextId++, body, rhs, hits, misses, step);
+
+    hypIndex.add(id, library.body(id));
+
+    if (config.hypStore == HYPSTORE_TRIE)
+        hypTrie.insert(id, library.body(id), conf(id));
+
+    if (config.matchKernel == MATCH_STRING)
+        bodyText.append(library.body(id));
+
+    longestBody = max(longestBody, library.bodyLength(id));
+
+    if (support(id) < config.minSupport)
+        lowSupport++;
+
+    return id;
+}
+
+//grows a hypothesis predicting rhs from a parent body of parentLength events
+int PslModel::growFrom(EventView sequence, int parentLength, const EventItem &rhs)
+{
+    int slen = sequence.length();
+    int vtFactor = max(parentLength + 1, (int) floor(parentLength * config.vtFactor));
+
+    if(vtFactor > slen )
+         vtFactor = slen;
+
+    //the new body is the only copy made: the last vtFactor events of the sequence, appended to the pool
+
+    // print_list(sequence.suffix(vtFactor));
+    // printf("->");
+    // print_event(rhs, stdout);
+
+    return addHypothesis(sequence.suffix(vtFactor), rhs);
+}
+
+Hypothesis PslModel::grow(EventView sequence, const Hypothesis &parent)
+{
+    return hypothesis(growFrom(sequence, parent.lhs.length(), parent.rhs));
+}
+
+Hypothesis PslModel::grow_sub(EventView sequence, const EventItem &parent)
+{
+    //if PSL failed to predict
+
+    // print_list(sequence.suffix(1));
+    // printf("->");
+    // print_event(parent, stdout);
+
+    return hypothesis(addHypothesis(sequence.suffix(1), parent)); //add the last event sequence
+}
+
+double PslModel::conf(int hypIndex) const
+{
+    double conf = (double) (library.bodyLength(hypIndex) * library.hits(hypIndex)) / (double)(library.hits(hypIndex) + library.misses(hypIndex));
+
+    // printf("%d %f \n", hypIndex, conf);
+
+    return conf;
+}
+
+int PslModel::support(int hypIndex) const
+{
+    return library.misses(hypIndex) + library.hits(hypIndex);
+}
+
+void PslModel::reward(int hypIndex, int value)
+{
+    if (value)
+    {
+        if (support(hypIndex) < config.minSupport && support(hypIndex) + value >= config.minSupport)
+            lowSupport--;
+
+        library.addHits(hypIndex, value);
+
+        if (config.hypStore == HYPSTORE_TRIE)
+            hypTrie.update(hypIndex, conf(hypIndex));
+    }
+}
+
+void PslModel::punish(int hypIndex, int value)
+{
+    //punish the hypothesis by increasing the value of its misses
+
+    if (value)
+    {
+        if (support(hypIndex) < config.minSupport && support(hypIndex) + value >= config.minSupport)
+            lowSupport--;
+
+        library.addMisses(hypIndex, value);
+
+        if (config.hypStore == HYPSTORE_TRIE)
+            hypTrie.update(hypIndex, conf(hypIndex));
+    }
+}
+
+int kernelMatch(EventView a, EventView b, int kernel, int k)
+{
+    if (kernel == MATCH_STRING)
+        return hyp_approxmatch_string(a, b, k);
+
+    if (kernel == MATCH_EXACT)
+        return hyp_approxmatch_exact(a, b);
+
+    return hyp_approxmatch_native(a, b, k);
+}
+
+double bodyMatch(EventView lhs, double conf, EventView sequence, int kernel, int k)
+{
+    //match the lhs of the hypothesis with a given sequence returning a certain confidence score
+    //adjusted for the length of the both sequences.
+    //both sides are compared through suffix views, nothing is copied.
+
+    int seqlen = sequence.length();
+    int hypLhsLen = lhs.length();
+
+    if(hypLhsLen == 0)
+        return conf;
+
+    else if(seqlen < hypLhsLen)
+    {
+        if(kernelMatch(lhs.suffix(seqlen), sequence, kernel, k) == 0)
+        {
+            double z = conf;
+            z = z / hypLhsLen * seqlen;
+
+            return z;
+        }
+    }
+
+    else if(kernelMatch(sequence.suffix(hypLhsLen), lhs, kernel, k) == 0)
+    {
+        return conf;
+    }
+
+    return 0.0;
+}
+
+int PslModel::approxmatch(EventView a, EventView b) const
+{
+    return kernelMatch(a, b, config.matchKernel, config.matchTol);
+}
+
+double PslModel::hypMatch(int hypIndex, EventView sequence) const
+{
+    return bodyMatch(library.body(hypIndex), conf(hypIndex), sequence, config.matchKernel, config.matchTol);
+}
+
+double PslModel::hypMatchText(int hypIndex, EventView sequence, const EventText &text, int first) const
+{
+    //same comparisons as hypMatch, on spans of the cached text instead of text built for the call
+
+    int seqlen = sequence.length();
+    int hypLhsLen = library.bodyLength(hypIndex);
+
+    if(hypLhsLen == 0)
+        return conf(hypIndex);
+
+    //events compared, the last n of both sides
+    int n = min(seqlen, hypLhsLen);
+
+    int from = seqlen - n - first;
+
+    if (from < 0)
+        return hypMatch(hypIndex, sequence);
+
+    const char *window = text.data(from);
+    int windowLen = text.span(from, from + n);
+
+    int stop = library.bodyStart(hypIndex) + hypLhsLen;
+
+    const char *lhs = bodyText.data(stop - n);
+    int lhsLen = bodyText.span(stop - n, stop);
+
+    if(seqlen < hypLhsLen)
+    {
+        if(approxmatchText(lhs, lhsLen, window, windowLen, config.matchTol) == 0)
+        {
+            double z = conf(hypIndex);
+            z = z / hypLhsLen * seqlen;
+
+            return z;
+        }
+    }
+
+    else if(approxmatchText(window, windowLen, lhs, lhsLen, config.matchTol) == 0)
+    {
+        return conf(hypIndex);
+    }
+
+    return 0.0;
+}
+
+//kernelMatch(a, b, Kernel, k) == 0 for the equal length windows hypMatch compares, inlined into the
+//scoring loops. MATCH_EXACT compares the packed events; MATCH_NATIVE only has the diagonal alignment
+//left when two indels cost more than the tolerance, and stops once the tolerance K is exceeded.
+template <int Kernel, int K>
+static inline bool windowMatch(EventView a, EventView b)
+{
+    if (Kernel == MATCH_EXACT)
+    {
+        for (int i = a.length() - 1; i >= 0; i--)
+        {
+            if (memcmp(&a[i], &b[i], sizeof(EventItem)) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    int d = 0;
+
+    for (int i = 0; i < a.length(); i++)
+    {
+        d += eventDistance(a[i], b[i], defaultEventCost);
+
+        if (d > K)
+            return false;
+    }
+
+    return true;
+}
+
+//hypMatch with the kernel, and for K >= 0 the tolerance, fixed at compile time
+template <int Kernel, int K>
+double PslModel::hypMatchAs(int hypIndex, EventView sequence) const
+{
+    if (Kernel == MATCH_STRING || (Kernel == MATCH_NATIVE && K < 0))
+        return hypMatch(hypIndex, sequence);
+
+    int hypLhsLen = library.bodyLength(hypIndex);
+
+    if(hypLhsLen == 0)
+        return conf(hypIndex);
+
+    int n = min(sequence.length(), hypLhsLen);
+
+    if (!windowMatch<Kernel, K>(sequence.suffix(n), library.body(hypIndex).suffix(n)))
+        return 0.0;
+
+    if (n < hypLhsLen)
+    {
+        double z = conf(hypIndex);
+        z = z / hypLhsLen * n;
+
+        return z;
+    }
+
+    return conf(hypIndex);
+}
+
+//the specialised scoring path for the configuration: the exact kernel and the native kernel at the
+//default tolerance run with constants, like the kernels hard-coded in hyp_approxmatch did
+int PslModel::scorePath() const
+{
+    if (config.matchKernel == MATCH_EXACT)
+        return SCOREPATH_EXACT;
+
+    if (config.matchKernel == MATCH_NATIVE && config.matchTol == MATCHTOL && 2 * defaultEventCost.indel > MATCHTOL)
+        return SCOREPATH_NATIVE;
+
+    return SCOREPATH_GENERIC;
+}
+
+template <int Kernel, int K>
+void PslModel::scoreRangeAs(EventView sequence, const vector<int> &ids, int begin, int end, const EventText *text, int first, double scores[]) const
+{
+    for (int i = begin; i < end; i++)
+    {
+        if (text != NULL)
+            scores[i] = hypMatchText(ids[i], sequence, *text, first);
+        else
+            scores[i] = hypMatchAs<Kernel, K>(ids[i], sequence);
+    }
+}
+
+void PslModel::scoreRange(EventView sequence, const vector<int> &ids, int begin, int end, const EventText *text, int first, double scores[]) const
+{
+    switch (scorePath())
+    {
+    case SCOREPATH_EXACT: scoreRangeAs<MATCH_EXACT, 0>(sequence, ids, begin, end, text, first, scores); break;
+    case SCOREPATH_NATIVE: scoreRangeAs<MATCH_NATIVE, MATCHTOL>(sequence, ids, begin, end, text, first, scores); break;
+    default: scoreRangeAs<MATCH_STRING, -1>(sequence, ids, begin, end, text, first, scores);
+    }
+}
+
+//ids of the hypotheses that can score above 0 for sequence, in increasing order.
+//hypMatch aligns the last event of the sequence with the last event of the body, so the index
+//only has to return the bodies whose last event can pass the kernel against the sequence tail.
+void PslModel::hypCandidates(EventView sequence, vector<int> &ids) const
+{
+    if (config.hypStore == HYPSTORE_TRIE && config.matchKernel == MATCH_EXACT)
+    {
+        hypTrie.candidates(sequence, ids);
+        return;
+    }
+
+    ids.clear();
+
+    int mode = hypIndex.getMode();
+
+    if (sequence.length() > 0 && mode != HYPINDEX_NONE)
+    {
+        if (mode == HYPINDEX_QUANTIZED)
+        {
+            hypIndex.candidatesQuantized(sequence.back(), ids);
+            return;
+        }
+
+        if (config.matchKernel == MATCH_EXACT)
+        {
+            hypIndex.candidatesExact(sequence.back(), ids);
+            return;
+        }
+
+        if (config.matchKernel == MATCH_NATIVE && hypIndex.candidatesWithin(sequence.back(), defaultEventCost, config.matchTol, ids))
+            return;
+    }
+
+    //decimal text of the string kernel is not aligned per event, every hypothesis is scored
+
+    ids.resize(library.size());
+
+    for (int i = 0; i < library.size(); i++)
+    {
+        ids[i] = i;
+    }
+}
+
+//number of chunks a pass over n candidates is split into, 1 when it runs serially
+int PslModel::scoreChunks(int n) const
+{
+    if (scorePool.size() == 1 || n < PARALLELMIN)
+        return 1;
+
+    return (n + PARALLELCHUNK - 1) / PARALLELCHUNK;
+}
+
+//arguments of a parallel scoring pass
+typedef struct
+{
+    const PslModel *model;
+    EventView sequence;
+    const EventItem *target;
+    const vector<int> *ids;
+    double *scores;
+    int n;
+    int chunk;
+    const EventText *text; //text of sequence from event first on, MATCH_STRING only
+    int first;
+
+} ScoreJob;
+
+void PslModel::scoreTask(void *context, int chunk)
+{
+    const ScoreJob &job = *(const ScoreJob *) context;
+
+    job.model->scoreRange(job.sequence, *job.ids, chunk * job.chunk, min(job.n, (chunk + 1) * job.chunk), job.text, job.first, job.scores);
+}
+
+//hypMatch of every candidate into scores[c]
+void PslModel::scoreCandidates(EventView sequence, const vector<int> &ids, double scores[]) const
+{
+    ScoreJob job;
+
+    job.model = this;
+    job.sequence = sequence;
+    job.target = NULL;
+    job.ids = &ids;
+    job.scores = scores;
+    job.n = ids.size();
+    job.text = NULL;
+    job.first = 0;
+
+    if (config.matchKernel == MATCH_STRING)
+    {
+        //no window reaches further back than the longest body
+        static thread_local EventText text;
+
+        job.first = max(0, sequence.length() - longestBody);
+        text.clear();
+        text.append(sequence.window(job.first, sequence.length()));
+        job.text = &text;
+    }
+
+    int chunks = scoreChunks(job.n);
+    job.chunk = (job.n + chunks - 1) / chunks;
+
+    scorePool.run(chunks, scoreTask, &job);
+}
+
+//id of the hypothesis selectHyp returns, -1 if none matches
+int PslModel::selectHypId(EventView seq) const
+{
+    if (config.hypStore == HYPSTORE_TRIE && config.matchKernel == MATCH_EXACT)
+    {
+        double score;
+
+        return hypTrie.best(seq, &score);
+    }
+
+    static thread_local vector<int> ids;
+    static thread_local vector<double> scores;
+
+    hypCandidates(seq, ids);
+
+    scores.resize(ids.size());
+    scoreCandidates(seq, ids, scores.data());
+
+    //serial reduction in id order, the same whatever the number of workers: the first highest score
+    int index = 0;
+    double best = 0.0;
+
+    for (size_t c = 0; c < ids.size(); c++)
+    {
+        double score = scores[c];
+
+        if (best < score)
+        {
+            index = ids[c];
+            best = score;
+        }
+    }
+
+    // if(best > 0.0) printf("| %d | \n", index);
+
+    return best > 0.0 ? index : -1;
+}
+
+Hypothesis PslModel::selectHyp(EventView seq) const
+{
+    int id = selectHypId(seq);
+
+    return id != -1 ? hypothesis(id) : newHyp();
+}
+
+void PslModel::getConfScores(EventView sequence, double hs[]) const
+{
+    if (library.size() == 0)
+        return;
+
+    static thread_local vector<int> ids;
+    static thread_local vector<double> scores;
+
+    hypCandidates(sequence, ids);
+
+    scores.resize(ids.size());
+    scoreCandidates(sequence, ids, scores.data());
+
+    fill(hs, hs + library.size(), 0.0);
+
+    for (size_t c = 0; c < ids.size(); c++)
+    {
+        hs[ids[c]] = scores[c];
+    }
+
+}
+
+//scores the candidates ids[begin, end) of a training step against the target t
+void PslModel::scoreStep(EventView sub, const EventItem &t, const vector<int> &ids, int begin, int end, const EventText *text, int first, StepResult &r) const
+{
+    switch (scorePath())
+    {
+    case SCOREPATH_EXACT: scoreStepAs<MATCH_EXACT, 0>(sub, t, ids, begin, end, text, first, r); break;
+    case SCOREPATH_NATIVE: scoreStepAs<MATCH_NATIVE, MATCHTOL>(sub, t, ids, begin, end, text, first, r); break;
+    default: scoreStepAs<MATCH_STRING, -1>(sub, t, ids, begin, end, text, first, r);
+    }
+}
+
+template <int Kernel, int K>
+void PslModel::scoreStepAs(EventView sub, const EventItem &t, const vector<int> &ids, int begin, int end, const EventText *text, int first, StepResult &r) const
+{
+    r.maxh = -1;
+    r.maxc = -1.0;
+    r.bestCorrect = -1;
+    r.rewarded.clear();
+    r.matched.clear();
+
+    for (int c = begin; c < end; c++)
+    {
+        int j = ids[c];
+        double conf = text != NULL ? hypMatchText(j, sub, *text, first) : hypMatchAs<Kernel, K>(j, sub);
+
+        if (conf > 0.0)
+        {
+            r.matched.push_back(j);
+
+            if (r.maxc < conf)
+            {
+                r.maxc = conf;
+                r.maxh = j;
+            }
+
+            if (eventcompare(library.rhs(j), t) == 0)
+            {
+                r.rewarded.push_back(j);
+
+                if (r.bestCorrect == -1 || library.bodyLength(r.bestCorrect) < library.bodyLength(j))
+                {
+                    r.bestCorrect = j;
+                }
+            }
+        }
+    }
+}
+
+//merges the result of the next chunk (higher ids) into r, keeping the first maximum as the serial loop does
+void PslModel::reduceStep(StepResult &r, const StepResult &next) const
+{
+    if (r.maxc < next.maxc)
+    {
+        r.maxc = next.maxc;
+        r.maxh = next.maxh;
+    }
+
+    if (next.bestCorrect != -1 && (r.bestCorrect == -1 || library.bodyLength(r.bestCorrect) < library.bodyLength(next.bestCorrect)))
+    {
+        r.bestCorrect = next.bestCorrect;
+    }
+
+    r.rewarded.insert(r.rewarded.end(), next.rewarded.begin(), next.rewarded.end());
+    r.matched.insert(r.matched.end(), next.matched.begin(), next.matched.end());
+}
+
+void PslModel::stepTask(void *context, int chunk)
+{
+    const ScoreJob &job = *(const ScoreJob *) context;
+    PslModel *model = (PslModel *) job.model;
+
+    model->scoreStep(job.sequence, *job.target, *job.ids, chunk * job.chunk, min(job.n, (chunk + 1) * job.chunk), job.text, job.first, model->stepResults[chunk]);
+}
+
+//applies a scored training step to the library
+void PslModel::commitStep(EventView sub, const EventItem &t, const StepResult &r)
+{
+    step++;
+
+    for (size_t c = 0; c < r.matched.size(); c++)
+    {
+        library.touch(r.matched[c], step);
+    }
+
+    for (size_t c = 0; c < r.rewarded.size(); c++)
+    {
+        reward(r.rewarded[c], 1);
+        // printf("reward(%d)\n" ,r.rewarded[c]+1);
+    }
+
+    //if the rhs sugessted doesn't match the next event in the sequence, punish the hypothesis
+
+    bool correct = (r.maxh != -1) && (eventcompare(library.rhs(r.maxh), t) == 0);
+
+    if(r.maxh != -1 && !correct)
+    {
+        punish(r.maxh, 1);
+        // printf("punish(%d)\n", r.maxh+1);
+    }
+
+    //psl learns only on failure
+    //hypothesis library is updated in grow
+
+    if(!correct)
+    {
+        if (r.bestCorrect == -1)
+        addHypothesis(sub.suffix(1), t);
+        else
+        growFrom(sub, library.bodyLength(r.bestCorrect), library.rhs(r.bestCorrect));
+    }
+}
+
+void PslModel::train(EventView sequence, int startIndex, int stopIndex)
+{
+    int seqlen = sequence.length();
+
+    if(seqlen < 2) return;
+
+    if (seqlen <= stopIndex || startIndex >= seqlen || startIndex > stopIndex)
+        return;
+
+    if(startIndex == 0) startIndex = 1;
+
+    vector<int> &ids = stepIds;
+
+    //the string kernel compares spans of the text of the events the steps can reach, built once for all steps.
+    //bodies grown longer during the loop fall back to hypMatch
+    const EventText *text = NULL;
+    int first = 0;
+
+    if (config.matchKernel == MATCH_STRING)
+    {
+        first = max(0, startIndex - longestBody);
+        stepText.clear();
+        stepText.append(sequence.window(first, stopIndex));
+        text = &stepText;
+    }
+
+    for (int i = startIndex; i < stopIndex + 1; i++)
+    {
+        //prefix view of the demonstration up to (excluding) the event to predict
+        EventView sub = sequence.prefix(i);
+        const EventItem &t = sequence[i];
+
+        //candidates never outnumber the library, leave room for it to grow without reallocating every step
+        if ((int) ids.capacity() < library.size())
+            ids.reserve(2 * library.size());
+
+        //hypotheses outside the candidates score 0 and would not change the step
+        hypCandidates(sub, ids);
+
+        ScoreJob job;
+
+        job.model = this;
+        job.sequence = sub;
+        job.target = &t;
+        job.ids = &ids;
+        job.scores = NULL;
+        job.n = ids.size();
+        job.text = text;
+        job.first = first;
+
+        int chunks = scoreChunks(job.n);
+        job.chunk = (job.n + chunks - 1) / chunks;
+
+        stepResults.resize(chunks);
+
+        scorePool.run(chunks, stepTask, &job);
+
+        //chunks are reduced in id order, so the step is the same for any number of workers
+        for (int c = 1; c < chunks; c++)
+        {
+            reduceStep(stepResults[0], stepResults[c]);
+        }
+
+        commitStep(sub, t, stepResults[0]);
+
+        //between steps, nothing refers to library slots
+        evict();
+    }
+
+    // print_hypotheses();
+
+}
+
+EventItem PslModel::predict(EventView seq) const
+{
+    int id = selectHypId(seq);
+
+    return id != -1 ? library.rhs(id) : newHyp().rhs;
+}
+
+//heap order of predictTopK: a is ranked before b
+static bool rankedBefore(const Prediction &a, const Prediction &b)
+{
+    return a.confidence > b.confidence || (a.confidence == b.confidence && a.id < b.id);
+}
+
+void PslModel::predictTopK(EventView seq, int k, vector<Prediction> &out) const
+{
+    out.clear();
+
+    if (k <= 0)
+        return;
+
+    static thread_local vector<int> ids;
+    static thread_local vector<double> scores;
+
+    hypCandidates(seq, ids);
+
+    scores.resize(ids.size());
+    scoreCandidates(seq, ids, scores.data());
+
+    //out is a heap with the lowest ranked of the k best on top
+    for (size_t c = 0; c < ids.size(); c++)
+    {
+        if (scores[c] <= 0.0)
+            continue;
+
+        Prediction p;
+
+        p.confidence = scores[c];
+        p.id = ids[c];
+
+        if ((int) out.size() == k)
+        {
+            if (!rankedBefore(p, out.front()))
+                continue;
+
+            pop_heap(out.begin(), out.end(), rankedBefore);
+            out.pop_back();
+        }
+
+        p.event = library.rhs(p.id);
+        p.support = support(p.id);
+
+        out.push_back(p);
+        push_heap(out.begin(), out.end(), rankedBefore);
+    }
+
+    sort_heap(out.begin(), out.end(), rankedBefore);
+}
+
+void PslModel::print_hypotheses(FILE * outFile) const
+{
+    for(int i=0; i< library.size(); i++)
+    {
+        print_list(library.body(i), outFile);
+
+        fprintf(outFile, "%s\n", "->");
+
+        print_event(library.rhs(i), outFile);
+
+        fprintf(outFile, "%s hits %d, misses %d \n", ":", library.hits(i), library.misses(i));
+
+    }
+}
+
+int PslModel::load_hypotheses(FILE * inFile)
+{
+    //read whole, then scanned by parseHypotheses
+    vector<char> text;
+    char block[65536];
+    size_t n;
+
+    while ((n = fread(block, 1, sizeof(block), inFile)) > 0)
+    {
+        text.insert(text.end(), block, block + n);
+    }
+
+    return parseHypotheses(text.data(), text.size(), *this);
+}
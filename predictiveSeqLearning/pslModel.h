@@ -0,0 +1,299 @@
+#ifndef PSLMODEL_H
+#define PSLMODEL_H
+
+#include <stdio.h>
+#include <vector>
+#include "eventSeq.h"
+#include "eventText.h"
+#include "hypLibrary.h"
+#include "hypIndex.h"
+#include "hypTrie.h"
+#include "threadPool.h"
+
+#define HYPCAPACITY 1024 //initial capacity of the library, it grows as hypotheses are learned
+#define VTFACTOR 2.0
+#define MATCHTOL 2
+#define PARALLELMIN 256  //fewest candidates scored in parallel
+#define PARALLELCHUNK 64 //candidates per parallel task
+
+//hyp_approxmatch kernels
+#define MATCH_STRING 0 //levDistance over the decimal text of the events, used for the results in applicationData/1
+#define MATCH_NATIVE 1 //eventSeqDistance over the event fields (default)
+#define MATCH_EXACT 2  //every event of the windows has to be equal
+
+//eviction policies, applied when the library grows past maxHypotheses
+#define EVICT_NONE 0        //the library grows without limit (default)
+#define EVICT_LRU 1         //least recently matched first
+#define EVICT_CONFSUPPORT 2 //lowest conf() * support() first
+#define EVICT_MINSUPPORT 3  //only hypotheses with support below minSupport, lowest support then conf first
+#define EVICTSLACK 16       //an eviction pass frees maxHypotheses / EVICTSLACK slots below the cap
+
+//scoring paths, see PslModel::scorePath
+#define SCOREPATH_GENERIC 0 //kernelMatch with the configured kernel and tolerance
+#define SCOREPATH_EXACT 1   //MATCH_EXACT inlined
+#define SCOREPATH_NATIVE 2  //MATCH_NATIVE inlined with k = MATCHTOL
+
+//hypothesis stores
+#define HYPSTORE_FLAT 0 //the library scanned through the index (default)
+#define HYPSTORE_TRIE 1 //reversed trie of the bodies, used with MATCH_EXACT
+
+using namespace std;
+
+//lhs represents the hypothesis body and rhs represents the head in PSL nomenclature
+//misses and hits are used to calculate the support and confidence of an hypothesis
+//id = -1 means the hypothesis is NULL (or empty). as C doesn't support assigning NULL to an hypothesis.
+//models keep their hypotheses in a HypLibrary, this is the value type of the API.
+
+typedef struct
+{
+
+    int id;
+    EventSeq lhs;
+    EventItem rhs;
+    int misses;
+    int hits;
+
+} Hypothesis;
+
+//one ranked prediction of predictTopK
+typedef struct
+{
+    EventItem event;    //rhs of the hypothesis
+    double confidence;  //its hypMatch score for the sequence
+    int id;             //slot of the hypothesis in the library
+    int support;        //hits + misses
+
+} Prediction;
+
+//parameters of a PSL model
+typedef struct
+{
+    double vtFactor;   //body growth factor of grow (VTFACTOR)
+    int matchKernel;   //MATCH_STRING, MATCH_NATIVE or MATCH_EXACT
+    int matchTol;      //k of the approximate kernels (MATCHTOL)
+    int capacity;      //hypotheses the library is allocated for up front (HYPCAPACITY)
+    int hypIndexMode;  //HYPINDEX_NONE, HYPINDEX_EXACT or HYPINDEX_QUANTIZED
+    int quantum;       //bucket width of HYPINDEX_QUANTIZED
+    int hypStore;      //HYPSTORE_FLAT or HYPSTORE_TRIE
+    int workers;       //scoring threads, the caller included
+    int evictionPolicy; //EVICT_NONE, EVICT_LRU, EVICT_CONFSUPPORT or EVICT_MINSUPPORT
+    int maxHypotheses;  //library size that triggers an eviction pass, 0 for no limit
+    int minSupport;     //support from which EVICT_MINSUPPORT keeps a hypothesis
+
+} PslConfig;
+
+//library counters
+typedef struct
+{
+    int live;          //hypotheses in the library
+    long evicted;      //hypotheses evicted since the library was cleared
+    long compactions;  //eviction passes
+    size_t bytes;      //memory held by the library
+
+} PslStats;
+
+//the defaults the free functions of pslImplementation.h run with
+PslConfig defaultPslConfig();
+
+//hyp_approxmatch with the given kernel and tolerance
+int kernelMatch(EventView a, EventView b, int kernel, int k);
+
+//hypMatch of a hypothesis body with confidence conf, for libraries held outside a model
+double bodyMatch(EventView lhs, double conf, EventView sequence, int kernel, int k);
+
+//a hypothesis library with its configuration, lookup structures and scoring threads.
+//models share no state, so different models can be trained and queried concurrently.
+//the const queries of one model can also run from several threads at once: their scratch is per thread
+//and a query that finds the scoring threads busy scores serially on its own thread.
+//training is not synchronised: train from one thread at a time, and do not query the model while it trains.
+
+class PslModel
+{
+public:
+    PslModel();
+
+    explicit PslModel(const PslConfig &config);
+
+    const PslConfig &getConfig() const { return config; }
+
+    //applies every parameter of config, the library is kept. capacity takes effect at the next init
+    void setConfig(const PslConfig &config);
+
+    //resets the library; the configuration is kept
+    void init();
+
+    void clearHypotheses();
+
+    void free_hyp();
+
+    void setMatchKernel(int kernel);
+
+    int getMatchKernel() const { return config.matchKernel; }
+
+    void setMatchTolerance(int k);
+
+    void setVtFactor(double vtFactor);
+
+    void setHypIndexMode(int mode, int quantum);
+
+    int getHypIndexMode() const { return config.hypIndexMode; }
+
+    void setHypStore(int store);
+
+    int getHypStore() const { return config.hypStore; }
+
+    void setWorkerCount(int workers);
+
+    int getWorkerCount() const { return config.workers; }
+
+    void setEvictionPolicy(int policy, int maxHypotheses, int minSupport);
+
+    PslStats getStats() const;
+
+    int size() const { return library.size(); }
+
+    //hypotheses are addressed by their slot in the library. an eviction pass renumbers the slots,
+    //the id of a Hypothesis is the number it was created with and does not change.
+
+    //a copy of the hypothesis with its body
+    Hypothesis hypothesis(int id) const;
+
+    const HypLibrary &getLibrary() const { return library; }
+
+    int getVtFactor(const Hypothesis &hyp) const;
+
+    Hypothesis grow(EventView sequence, const Hypothesis &parent);
+
+    Hypothesis grow_sub(EventView sequence, const EventItem &parent);
+
+    double conf(int hypIndex) const;
+
+    int support(int hypIndex) const;
+
+    void reward(int hypIndex, int value);
+
+    void punish(int hypIndex, int value);
+
+    //hyp_approxmatch with the kernel and tolerance of the model
+    int approxmatch(EventView a, EventView b) const;
+
+    double hypMatch(int hypIndex, EventView sequence) const;
+
+    void hypCandidates(EventView sequence, vector<int> &ids) const;
+
+    Hypothesis selectHyp(EventView seq) const;
+
+    void getConfScores(EventView sequence, double hs[]) const;
+
+    void train(EventView sequence, int startIndex, int stopIndex);
+
+    EventItem predict(EventView seq) const;
+
+    //the k best scoring hypotheses for seq, highest confidence first and the lower slot first on ties, so
+    //out[0] is what predict returns. fewer than k if fewer hypotheses match. the candidates are scored
+    //once and kept in a heap of k entries
+    void predictTopK(EventView seq, int k, vector<Prediction> &out) const;
+
+    void print_hypotheses(FILE * outFile) const;
+
+    //appends the hypotheses written by print_hypotheses to the library, returns how many were read or -1 if
+    //the file is not in that format (the hypotheses before the error are kept)
+    int load_hypotheses(FILE * inFile);
+
+    //appends a hypothesis with its counts, as loading a saved library does; returns its slot
+    int restoreHypothesis(EventView body, const EventItem &rhs, int hits, int misses);
+
+private:
+    //what a training step reads from the library for one chunk of candidates, or for all of them once reduced
+    typedef struct
+    {
+        int maxh;              //first hypothesis with the highest score
+        double maxc;
+        int bestCorrect;       //first of the longest hypotheses predicting the target
+        vector<int> rewarded;  //every matching hypothesis predicting the target, in id order
+        vector<int> matched;   //every hypothesis scoring above 0, for EVICT_LRU
+
+    } StepResult;
+
+    //appends the hypothesis body -> rhs, returns its id
+    int addHypothesis(EventView body, const EventItem &rhs);
+
+    int growFrom(EventView sequence, int parentLength, const EventItem &rhs);
+
+    int selectHypId(EventView seq) const;
+
+    //hypMatch of the string kernel on cached text: text holds the text of the events of sequence from
+    //event first on. windows starting before first fall back to hypMatch
+    double hypMatchText(int hypIndex, EventView sequence, const EventText &text, int first) const;
+
+    //keeps bodyText equal to the text of the event pool while the string kernel is selected
+    void rebuildBodyText();
+
+    int scoreChunks(int n) const;
+
+    //hypMatch with the kernel, and the tolerance if K >= 0, fixed at compile time
+    template <int Kernel, int K>
+    double hypMatchAs(int hypIndex, EventView sequence) const;
+
+    int scorePath() const;
+
+    //scores[i] = hypMatch(ids[i]) for i in [begin, end), through the scoring path of the configuration
+    void scoreRange(EventView sequence, const vector<int> &ids, int begin, int end, const EventText *text, int first, double scores[]) const;
+
+    template <int Kernel, int K>
+    void scoreRangeAs(EventView sequence, const vector<int> &ids, int begin, int end, const EventText *text, int first, double scores[]) const;
+
+    void scoreCandidates(EventView sequence, const vector<int> &ids, double scores[]) const;
+
+    void scoreStep(EventView sub, const EventItem &t, const vector<int> &ids, int begin, int end, const EventText *text, int first, StepResult &r) const;
+
+    template <int Kernel, int K>
+    void scoreStepAs(EventView sub, const EventItem &t, const vector<int> &ids, int begin, int end, const EventText *text, int first, StepResult &r) const;
+
+    void reduceStep(StepResult &r, const StepResult &next) const;
+
+    void commitStep(EventView sub, const EventItem &t, const StepResult &r);
+
+    //thread pool tasks: scoreCandidates and scoreStep over one chunk of candidates
+    static void scoreTask(void *context, int chunk);
+
+    static void stepTask(void *context, int chunk);
+
+    //priority of a hypothesis under the eviction policy, lowest is evicted first
+    double evictionPriority(int slot) const;
+
+    //evicts down to the cap if the library is above it, then rebuilds the lookup structures
+    void evict();
+
+    //recounts lowSupport after minSupport or the slots change
+    void countLowSupport();
+
+    void rebuildLookup();
+
+    PslConfig config;
+
+    //the library is only written between scoring passes (grow, reward, punish, commitStep), so the
+    //workers of a pass all read the same hypotheses without locking.
+    HypLibrary library;
+    int nextId;
+    int longestBody; //no body of the library is longer
+    long step;      //training steps since the library was cleared
+    int lowSupport; //hypotheses with support below minSupport, the ones EVICT_MINSUPPORT may evict
+    long evicted;
+    long compactions;
+
+    HypIndex hypIndex;
+    HypTrie hypTrie;
+
+    //text of the event pool for MATCH_STRING: a body is compared without building its text every step
+    EventText bodyText;
+
+    mutable ThreadPool scorePool; //reentrant, shared by concurrent queries
+
+    //training scratch, reused across steps
+    vector<int> stepIds;
+    vector<StepResult> stepResults;
+    EventText stepText; //text of the sequence being trained, MATCH_STRING only
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include "pslImplementation.h"
+
+PslSession::PslSession(PslModel &model) : model(model)
+{
+    trained = 0;
+}
+
+void PslSession::observe(const EventItem &event)
+{
+    events.push(event);
+
+    //the first event of a demonstration has nothing to be predicted from
+    int n = events.length() - 1;
+
+    if (n < 1)
+        return;
+
+    model.train(events.view(), n, n);
+    trained++;
+}
+
+void PslSession::observe(EventUnion event, int eventtype)
+{
+    observe(makeEventItem(event, eventtype));
+}
+
+EventItem PslSession::predict() const
+{
+    return model.predict(events.view());
+}
+
+void PslSession::predictTopK(int k, vector<Prediction> &out) const
+{
+    model.predictTopK(events.view(), k, out);
+}
+
+void PslSession::finish()
+{
+    //the storage is kept for the next demonstration
+    events.clear();
+}
@@ -0,0 +1,52 @@
+#ifndef PSLSESSION_H
+#define PSLSESSION_H
+
+#include "eventSeq.h"
+#include "pslModel.h"
+
+//streaming training: the events of a demonstration are handed over one at a time as they happen.
+//observe trains the model on predicting the new event from the events before it, which is the step
+//train(sequence, n, n) would make, so a demonstration observed event by event leaves the model as
+//train(sequence, 0, length - 1) does. a step only looks at the last events of the running sequence
+//(hypothesis bodies and the grown suffix), so its cost does not grow with the demonstration.
+//no per-hypothesis match state is kept between steps: hypMatch aligns every body with the tail, so
+//each new event moves every window and nothing of the previous match carries over. a step is a full
+//scoring pass over the candidates of the library, as a step of train is.
+//a session is used from one thread, and the model it trains follows the rules of PslModel.
+
+class PslSession
+{
+public:
+    explicit PslSession(PslModel &model);
+
+    //appends an event to the running demonstration and trains on it
+    void observe(const EventItem &event);
+
+    void observe(EventUnion event, int eventtype);
+
+    //prediction of the next event from the running demonstration
+    EventItem predict() const;
+
+    //the k best predictions of the next event, see PslModel::predictTopK
+    void predictTopK(int k, vector<Prediction> &out) const;
+
+    //ends the running demonstration, the next event starts a new one
+    void finish();
+
+    //events of the running demonstration
+    EventView sequence() const { return events.view(); }
+
+    int length() const { return events.length(); }
+
+    //training steps made since the session was created
+    long steps() const { return trained; }
+
+    PslModel &getModel() const { return model; }
+
+private:
+    PslModel &model;
+    EventSeq events;
+    long trained;
+};
+
+#endif
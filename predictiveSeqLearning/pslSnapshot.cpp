@@ -0,0 +1,183 @@
+#include <string.h>
+#include "pslImplementation.h"
+#include "pslSnapshot.h"
+
+#define SNAPSHOTALIGN 8
+
+static uint64_t alignOffset(uint64_t offset)
+{
+    return (offset + SNAPSHOTALIGN - 1) / SNAPSHOTALIGN * SNAPSHOTALIGN;
+}
+
+//writes count items at offset, padding the file up to it
+static bool writeArray(FILE *outFile, uint64_t offset, const void *items, size_t size, size_t count)
+{
+    static const char padding[SNAPSHOTALIGN] = {0};
+
+    long position = ftell(outFile);
+
+    if (position < 0 || (uint64_t) position > offset)
+        return false;
+
+    if (fwrite(padding, 1, offset - position, outFile) != offset - position)
+        return false;
+
+    return count == 0 || fwrite(items, size, count, outFile) == count;
+}
+
+int writeSnapshot(const PslModel &model, const char *path)
+{
+    const HypLibrary &library = model.getLibrary();
+
+    int n = library.size();
+
+    vector<int32_t> hits(n), misses(n), starts(n), lengths(n);
+    vector<EventItem> heads(n);
+    vector<EventItem> pool;
+
+    pool.reserve(library.events());
+
+    for (int i = 0; i < n; i++)
+    {
+        EventView body = library.body(i);
+
+        hits[i] = library.hits(i);
+        misses[i] = library.misses(i);
+        starts[i] = pool.size();
+        lengths[i] = body.length();
+        heads[i] = library.rhs(i);
+
+        pool.insert(pool.end(), body.items, body.items + body.length());
+    }
+
+    PslSnapshotHeader header;
+
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, PSLSNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = PSLSNAPSHOT_VERSION;
+    header.byteOrder = 0x01020304;
+    header.eventSize = sizeof(EventItem);
+    header.hypotheses = n;
+    header.events = pool.size();
+
+    header.hitsOffset = alignOffset(sizeof(header));
+    header.missesOffset = alignOffset(header.hitsOffset + n * sizeof(int32_t));
+    header.startsOffset = alignOffset(header.missesOffset + n * sizeof(int32_t));
+    header.lengthsOffset = alignOffset(header.startsOffset + n * sizeof(int32_t));
+    header.headsOffset = alignOffset(header.lengthsOffset + n * sizeof(int32_t));
+    header.poolOffset = alignOffset(header.headsOffset + n * sizeof(EventItem));
+    header.size = header.poolOffset + pool.size() * sizeof(EventItem);
+
+    FILE *outFile = fopen(path, "wb");
+
+    if (outFile == NULL)
+        return -1;
+
+    bool written = fwrite(&header, sizeof(header), 1, outFile) == 1
+        && writeArray(outFile, header.hitsOffset, hits.data(), sizeof(int32_t), n)
+        && writeArray(outFile, header.missesOffset, misses.data(), sizeof(int32_t), n)
+        && writeArray(outFile, header.startsOffset, starts.data(), sizeof(int32_t), n)
+        && writeArray(outFile, header.lengthsOffset, lengths.data(), sizeof(int32_t), n)
+        && writeArray(outFile, header.headsOffset, heads.data(), sizeof(EventItem), n)
+        && writeArray(outFile, header.poolOffset, pool.data(), sizeof(EventItem), pool.size());
+
+    if (fclose(outFile) != 0)
+        written = false;
+
+    return written ? 0 : -1;
+}
+
+PslSnapshot::PslSnapshot()
+{
+    header = NULL;
+    hitCounts = missCounts = starts = lengths = NULL;
+    heads = pool = NULL;
+}
+
+PslSnapshot::~PslSnapshot()
+{
+    close();
+}
+
+void PslSnapshot::close()
+{
+    file.close();
+
+    header = NULL;
+    hitCounts = missCounts = starts = lengths = NULL;
+    heads = pool = NULL;
+}
+
+//true if count items of size bytes at offset lie inside the file
+static bool inFile(uint64_t offset, uint64_t size, int64_t count, uint64_t length)
+{
+    return count >= 0 && offset <= length && (uint64_t) count * size <= length - offset;
+}
+
+bool PslSnapshot::open(const char *path)
+{
+    close();
+
+    //copyTo reads the six arrays side by side rather than front to back, so no advice is given
+    if (!file.open(path, MAPPED_NORMAL) || file.size() < sizeof(PslSnapshotHeader))
+    {
+        file.close();
+        return false;
+    }
+
+    size_t length = file.size();
+
+    const char *base = file.data();
+    const PslSnapshotHeader *h = (const PslSnapshotHeader *) base;
+
+    bool valid = strncmp(h->magic, PSLSNAPSHOT_MAGIC, sizeof(h->magic)) == 0
+        && h->version == PSLSNAPSHOT_VERSION
+        && h->byteOrder == 0x01020304
+        && h->eventSize == sizeof(EventItem)
+        && h->size == length
+        && inFile(h->hitsOffset, sizeof(int32_t), h->hypotheses, length)
+        && inFile(h->missesOffset, sizeof(int32_t), h->hypotheses, length)
+        && inFile(h->startsOffset, sizeof(int32_t), h->hypotheses, length)
+        && inFile(h->lengthsOffset, sizeof(int32_t), h->hypotheses, length)
+        && inFile(h->headsOffset, sizeof(EventItem), h->hypotheses, length)
+        && inFile(h->poolOffset, sizeof(EventItem), h->events, length);
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    header = h;
+    hitCounts = (const int32_t *) (base + h->hitsOffset);
+    missCounts = (const int32_t *) (base + h->missesOffset);
+    starts = (const int32_t *) (base + h->startsOffset);
+    lengths = (const int32_t *) (base + h->lengthsOffset);
+    heads = (const EventItem *) (base + h->headsOffset);
+    pool = (const EventItem *) (base + h->poolOffset);
+
+    //bodies have to stay inside the pool
+    for (int i = 0; i < h->hypotheses; i++)
+    {
+        if (starts[i] < 0 || lengths[i] < 0 || starts[i] > h->events - lengths[i])
+        {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+double PslSnapshot::conf(int i) const
+{
+    return (double) (lengths[i] * hitCounts[i]) / (double)(hitCounts[i] + missCounts[i]);
+}
+
+void PslSnapshot::copyTo(PslModel &model) const
+{
+    for (int i = 0; i < size(); i++)
+    {
+        model.restoreHypothesis(body(i), rhs(i), hits(i), misses(i));
+    }
+}
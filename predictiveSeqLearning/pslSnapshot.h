@@ -0,0 +1,89 @@
+#ifndef PSLSNAPSHOT_H
+#define PSLSNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "eventSeq.h"
+#include "mappedFile.h"
+#include "pslModel.h"
+
+//binary snapshot of a hypothesis library, a load format only: it is mapped and copied into a model,
+//which rebuilds its lookup structures and answers the queries. it replaces parsing the hypotheses text,
+//no prediction is made from the mapping.
+//layout: the header, then the hits, misses, body offsets and body lengths as int32 arrays, the heads and
+//the event pool as packed EventItems. offsets in the header are from the start of the file.
+//a snapshot is written and read by the same build: the header records the layout it was written with.
+
+#define PSLSNAPSHOT_MAGIC "PSLSNAP"
+#define PSLSNAPSHOT_VERSION 1
+
+typedef struct
+{
+    char magic[8];        //PSLSNAPSHOT_MAGIC
+    uint32_t version;     //PSLSNAPSHOT_VERSION
+    uint32_t byteOrder;   //0x01020304 as written
+    uint32_t eventSize;   //sizeof(EventItem)
+    int32_t hypotheses;
+    int32_t events;       //events in the pool
+    uint32_t reserved;
+    uint64_t hitsOffset;
+    uint64_t missesOffset;
+    uint64_t startsOffset;
+    uint64_t lengthsOffset;
+    uint64_t headsOffset;
+    uint64_t poolOffset;
+    uint64_t size;        //bytes in the file
+
+} PslSnapshotHeader;
+
+//writes the library of the model, returns 0 or -1 if the file could not be written
+int writeSnapshot(const PslModel &model, const char *path);
+
+//read-only view of a mapped snapshot, for copyTo and inspection. hypotheses are in the order of the
+//library they were written from.
+
+class PslSnapshot
+{
+public:
+    PslSnapshot();
+
+    ~PslSnapshot();
+
+    //maps the file and checks its header, false if it is not a snapshot of this version and layout
+    bool open(const char *path);
+
+    void close();
+
+    bool isOpen() const { return header != NULL; }
+
+    int size() const { return header != NULL ? header->hypotheses : 0; }
+
+    EventView body(int i) const { return EventView(pool + starts[i], lengths[i]); }
+
+    const EventItem &rhs(int i) const { return heads[i]; }
+
+    int hits(int i) const { return hitCounts[i]; }
+
+    int misses(int i) const { return missCounts[i]; }
+
+    double conf(int i) const;
+
+    //appends the hypotheses to the library of the model
+    void copyTo(PslModel &model) const;
+
+private:
+    PslSnapshot(const PslSnapshot &);
+    PslSnapshot &operator=(const PslSnapshot &);
+
+    MappedFile file;
+
+    const PslSnapshotHeader *header;
+    const int32_t *hitCounts;
+    const int32_t *missCounts;
+    const int32_t *starts;
+    const int32_t *lengths;
+    const EventItem *heads;
+    const EventItem *pool;
+};
+
+#endif
@@ -0,0 +1,1172 @@
+//micro-benchmarks for the PSL hot paths
+//usage: pslbench [trainingdata file]
+//       pslbench --verify hypotheses files...   differential check of levDistanceBounded and
+//                                               levDistanceIsa against levDistance
+//       pslbench --json [trainingdata file]     micro-benchmarks of the hot paths as JSON on stdout:
+//                                               ns, allocations and bytes allocated per operation
+
+#include <time.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "pslImplementation.h"
+#include "pslEval.h"
+#include "allocCounter.h"
+#include "mappedFile.h"
+
+#define DEFAULT_TRAININGDATA "../applicationData/1/trainingdata.txt"
+#define BODYLENGTHS 5
+#define VERIFYBOUNDS 5
+#define SNAPSHOTPATH "/tmp/pslbench.psl"
+#define LARGELOGPATH "/tmp/pslbench_trainingdata.txt"
+#define LARGELOGCOPIES 64
+#define BINARYLOGPATH "/tmp/pslbench_demos.log"
+#define CORPUSPATH "/tmp/pslbench_corpus_%d.txt"
+#define CORPUSFILES 8
+#define MICROTIME 2e8 //ns each micro-benchmark runs for at least
+#define MICROWINDOW 16 //events of the sequences hypMatch, getConfScores and selectHyp are given
+#define LOGBURST 2048 //events the control loop logs between two pauses of the binary log benchmark
+
+using namespace std;
+
+typedef struct
+{
+    EventView a;
+    EventView b;
+
+} EventPair;
+
+//the demonstrations of a trainingdata file or binary log, as hyptrain reads them
+void loadDemonstrations(const char *path, vector<EventSeq> &demos)
+{
+    TrainingData data;
+
+    if (data.load(path) < 0)
+        return;
+
+    demos.resize(data.size());
+
+    for (int i = 0; i < data.size(); i++)
+    {
+        demos[i].assign(data.demo(i));
+    }
+}
+
+//pairs of equal-length windows, the shape hypMatch compares: a sequence tail against a hypothesis body
+void buildPairs(const vector<EventSeq> &demos, vector<EventPair> &pairs)
+{
+    const int lengths[BODYLENGTHS] = {1, 2, 4, 8, 16};
+
+    for (int l = 0; l < BODYLENGTHS; l++)
+    {
+        int len = lengths[l];
+
+        for (size_t d = 0; d < demos.size(); d++)
+        {
+            const EventSeq &src = demos[d];
+            const EventSeq &dst = demos[(d + 1) % demos.size()];
+
+            for (int i = 0; i + len <= src.length() && i + len <= dst.length(); i += 3)
+            {
+                int j = (i * 7) % (dst.length() - len + 1);
+
+                EventPair p;
+                p.a = src.view().window(i, i + len);
+                p.b = dst.view().window(j, j + len);
+                pairs.push_back(p);
+            }
+        }
+    }
+}
+
+//decimal text of a window, as hyp_approxmatch_string builds it
+string eventString(EventView seq)
+{
+    string s;
+
+    for (int i = 0; i < seq.length(); i++)
+    {
+        const signed char *f = (const signed char *) &seq[i].event;
+
+        for (int j = 0; j < EVENTFIELDS; j++)
+        {
+            s += to_string((int) f[j]);
+        }
+    }
+
+    return s;
+}
+
+double benchApproxmatch(const vector<string> &a, const vector<string> &b, int type, int reps, int *matches)
+{
+    struct timespec start, end;
+    int m = 0;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    for (int r = 0; r < reps; r++)
+    {
+        m = 0;
+
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (approxmatch(a[i], b[i], MATCHTOL, type) == 0)
+                m++;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    *matches = m;
+
+    return elapsed_ns(end, start) / ((double) reps * a.size());
+}
+
+double benchLevDistance(const vector<string> &a, const vector<string> &b, int bound, int reps, int *matches)
+{
+    struct timespec start, end;
+    int m = 0;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    for (int r = 0; r < reps; r++)
+    {
+        m = 0;
+
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            int d = bound < 0 ? levDistance(a[i], b[i]) : levDistanceBounded(a[i], b[i], bound);
+
+            if (d <= MATCHTOL)
+                m++;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    *matches = m;
+
+    return elapsed_ns(end, start) / ((double) reps * a.size());
+}
+
+//hypothesis bodies of a print_hypotheses dump, as the decimal text hyp_approxmatch_string compares
+void loadBodyStrings(const char *path, vector<string> &bodies)
+{
+    ifstream inFile;
+    inFile.open(path);
+
+    string line;
+    string body;
+    bool inBody = true;
+    int v[5];
+
+    while (getline(inFile, line))
+    {
+        if (line == "->")
+        {
+            bodies.push_back(body);
+            body.clear();
+            inBody = false;
+        }
+        else if (line.size() > 0 && line[0] == ':')
+            inBody = true;
+        else if (inBody && sscanf(line.c_str(), " %d %d %d %d %d", &v[0], &v[1], &v[2], &v[3], &v[4]) == 5)
+        {
+            for (int j = 0; j < 5; j++)
+            {
+                body += to_string(v[j]);
+            }
+        }
+    }
+}
+
+//writes copies of the trainingdata file one after the other, returns the bytes written
+long writeLargeLog(const char *path, const char *largePath, int copies)
+{
+    ifstream inFile(path);
+    string text((istreambuf_iterator<char>(inFile)), istreambuf_iterator<char>());
+
+    //only finished demonstrations are read, and "end" would stop the reader at the first copy
+    size_t end = text.find("\nend");
+
+    if (end != string::npos)
+        text.resize(end + 1);
+
+    FILE *outFile = fopen(largePath, "w");
+
+    if (outFile == NULL)
+        return 0;
+
+    for (int c = 0; c < copies; c++)
+    {
+        fwrite(text.data(), 1, text.size(), outFile);
+    }
+
+    fclose(outFile);
+
+    return (long) text.size() * copies;
+}
+
+//getline and sscanf reader of the print_hypotheses format, the baseline of parseHypotheses
+int loadHypothesesStream(const char *path, PslModel &model)
+{
+    ifstream inFile(path);
+
+    string line;
+    EventSeq lhs;
+    EventItem rhs;
+    EventUnion e;
+    int v[5], end, hits, misses;
+    int count = 0;
+
+    while (getline(inFile, line))
+    {
+        if (line == "->")
+        {
+            getline(inFile, line);
+            sscanf(line.c_str(), " %d %d %d %d %d%n", &v[0], &v[1], &v[2], &v[3], &v[4], &end);
+            e.action.deltaX = v[0]; e.action.deltaY = v[1]; e.action.deltaZ = v[2]; e.action.deltaangle = v[3]; e.action.grasp = v[4];
+            rhs = makeEventItem(e, line[end] == ' ' ? 1 : 2);
+
+            getline(inFile, line);
+            sscanf(line.c_str(), " : hits %d, misses %d", &hits, &misses);
+
+            model.restoreHypothesis(lhs, rhs, hits, misses);
+            lhs.clear();
+            count++;
+        }
+        else if (sscanf(line.c_str(), " %d %d %d %d %d%n", &v[0], &v[1], &v[2], &v[3], &v[4], &end) == 5)
+        {
+            e.action.deltaX = v[0]; e.action.deltaY = v[1]; e.action.deltaZ = v[2]; e.action.deltaangle = v[3]; e.action.grasp = v[4];
+            lhs.push(makeEventItem(e, line[end] == ' ' ? 1 : 2));
+        }
+    }
+
+    return count;
+}
+
+//the hypothesis dumps of applicationData/1 next to the trainingdata file
+void hypothesisFiles(const char *trainingdata, vector<string> &paths)
+{
+    string dir(trainingdata);
+    size_t slash = dir.rfind('/');
+
+    dir = slash == string::npos ? "" : dir.substr(0, slash + 1);
+
+    const int lengths[4] = {5, 10, 15, 21};
+
+    for (int l = 0; l < 4; l++)
+    {
+        for (int a = 0; a < 3; a++)
+        {
+            for (int q = 10; q <= 20; q += 10)
+            {
+                paths.push_back(dir + "hypotheses_" + to_string(lengths[l]) + "_a" + to_string(a) + "_q" + to_string(q) + ".txt");
+            }
+        }
+    }
+}
+
+//loads every file into its own model, returns ms; *hypotheses and *bytes are the totals
+double benchLoad(const vector<string> &paths, int threads, bool stream, long *hypotheses, long *bytes)
+{
+    vector<PslModel *> models(paths.size());
+    vector<int> counts;
+
+    for (size_t f = 0; f < paths.size(); f++)
+    {
+        models[f] = new PslModel();
+    }
+
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    if (stream)
+    {
+        counts.resize(paths.size());
+
+        for (size_t f = 0; f < paths.size(); f++)
+        {
+            counts[f] = loadHypothesesStream(paths[f].c_str(), *models[f]);
+        }
+    }
+    else
+        loadHypothesisFiles(paths, models, threads, counts);
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    *hypotheses = 0;
+    *bytes = 0;
+
+    for (size_t f = 0; f < paths.size(); f++)
+    {
+        *hypotheses += counts[f] > 0 ? counts[f] : 0;
+
+        FILE *inFile = fopen(paths[f].c_str(), "r");
+
+        if (inFile != NULL)
+        {
+            fseek(inFile, 0, SEEK_END);
+            *bytes += ftell(inFile);
+            fclose(inFile);
+        }
+
+        delete models[f];
+    }
+
+    return elapsed_ns(end, start) * 1e-6;
+}
+
+//compares levDistanceBounded and every supported levDistanceIsa path with levDistance
+//on every pair of distinct bodies
+int verifyBounded(int nfiles, char **files)
+{
+    const int bounds[VERIFYBOUNDS] = {0, 1, 2, 4, 8};
+
+    vector<string> bodies;
+
+    for (int f = 0; f < nfiles; f++)
+    {
+        loadBodyStrings(files[f], bodies);
+    }
+
+    sort(bodies.begin(), bodies.end());
+    bodies.erase(unique(bodies.begin(), bodies.end()), bodies.end());
+
+    long pairs = 0, checks = 0, mismatches = 0;
+
+    for (size_t a = 0; a < bodies.size(); a++)
+    {
+        for (size_t b = a; b < bodies.size(); b++)
+        {
+            pairs++;
+
+            int lendiff = abs((int) bodies[a].length() - (int) bodies[b].length());
+
+            //levDistance >= lendiff, so past the largest bound both sides only have to agree on k + 1
+            int reference = lendiff > bounds[VERIFYBOUNDS - 1] ? lendiff : levDistance(bodies[a], bodies[b]);
+
+            for (int isa = LEV_SCALAR; lendiff <= bounds[VERIFYBOUNDS - 1] && isa <= levDistanceIsaSupported(); isa++)
+            {
+                checks++;
+
+                if (levDistanceIsa(bodies[a], bodies[b], isa) != reference)
+                {
+                    mismatches++;
+
+                    if (mismatches <= 10)
+                        printf("mismatch isa=%d: \"%s\" \"%s\" levDistance %d\n", isa, bodies[a].c_str(), bodies[b].c_str(), reference);
+                }
+            }
+
+            for (int i = 0; i < VERIFYBOUNDS; i++)
+            {
+                int k = bounds[i];
+                int expected = reference > k ? k + 1 : reference;
+
+                checks++;
+
+                if (levDistanceBounded(bodies[a], bodies[b], k) != expected || levDistanceBounded(bodies[b], bodies[a], k) != expected)
+                {
+                    mismatches++;
+
+                    if (mismatches <= 10)
+                        printf("mismatch k=%d: \"%s\" \"%s\" levDistance %d\n", k, bodies[a].c_str(), bodies[b].c_str(), reference);
+                }
+            }
+        }
+    }
+
+    printf("%d distinct bodies, %ld pairs, %ld checks, %ld mismatches\n", (int) bodies.size(), pairs, checks, mismatches);
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+//full-matrix levDistance through one instruction set, in matrix cells per second
+double benchLevIsa(const vector<string> &a, const vector<string> &b, int isa, int reps)
+{
+    struct timespec start, end;
+    double cells = 0.0;
+    int sink = 0;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    for (int r = 0; r < reps; r++)
+    {
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            sink += isa < 0 ? levDistance(a[i], b[i]) : levDistanceIsa(a[i], b[i], isa);
+            cells += (double) a[i].length() * b[i].length();
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    if (sink < 0) printf("%d", sink);
+
+    return cells / (elapsed_ns(end, start) * 1e-9);
+}
+
+double benchKernel(int (*kernel)(EventView, EventView), const vector<EventPair> &pairs, int reps, int *matches)
+{
+    struct timespec start, end;
+    int m = 0;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    for (int r = 0; r < reps; r++)
+    {
+        m = 0;
+
+        for (size_t i = 0; i < pairs.size(); i++)
+        {
+            if (kernel(pairs[i].a, pairs[i].b) == 0)
+                m++;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    *matches = m;
+
+    return elapsed_ns(end, start) / ((double) reps * pairs.size());
+}
+
+//predict on every prefix of the demonstrations, returns ns per call and the mean number of scored hypotheses
+double benchPredict(const vector<EventSeq> &demos, int reps, double *candidates, int *predicted)
+{
+    struct timespec start, end;
+    vector<int> ids;
+    long calls = 0, scored = 0;
+    int p = 0;
+
+    for (size_t d = 0; d < demos.size(); d++)
+    {
+        for (int i = 1; i < demos[d].length(); i++)
+        {
+            hypCandidates(demos[d].prefix(i), ids);
+            scored += ids.size();
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    for (int r = 0; r < reps; r++)
+    {
+        p = 0;
+
+        for (size_t d = 0; d < demos.size(); d++)
+        {
+            for (int i = 1; i < demos[d].length(); i++)
+            {
+                if (predict(demos[d].prefix(i)).eventtype != 0)
+                    p++;
+
+                if (r == 0)
+                    calls++;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    *candidates = (double) scored / calls;
+    *predicted = p;
+
+    return elapsed_ns(end, start) / ((double) reps * calls);
+}
+
+//trains a new library on all demonstrations, returns ms
+double benchTrain(const vector<EventSeq> &demos)
+{
+    struct timespec start, end;
+
+    clearHypotheses();
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    for (size_t d = 0; d < demos.size(); d++)
+    {
+        train(demos[d], 0, demos[d].length() - 1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    return elapsed_ns(end, start) * 1e-6;
+}
+
+//heap allocations of the training steps and predictions of a trained model, after a warm-up pass
+//that lets the scratch buffers reach their size. steps that learn a hypothesis are counted apart.
+void benchAllocs(PslModel &model, const vector<EventSeq> &demos, const char *name)
+{
+    for (size_t d = 0; d < demos.size(); d++)
+    {
+        model.train(demos[d], 0, demos[d].length() - 1);
+    }
+
+    long steady = 0, steadyAllocs = 0, growing = 0, growingAllocs = 0;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        steady = steadyAllocs = growing = growingAllocs = 0;
+
+        for (size_t d = 0; d < demos.size(); d++)
+        {
+            for (int i = 1; i < demos[d].length(); i++)
+            {
+                int before = model.size();
+                long allocs = allocCount().allocs;
+
+                model.train(demos[d], i, i);
+
+                allocs = allocCount().allocs - allocs;
+
+                if (model.size() > before)
+                {
+                    growing++;
+                    growingAllocs += allocs;
+                }
+                else
+                {
+                    steady++;
+                    steadyAllocs += allocs;
+                }
+            }
+        }
+    }
+
+    long calls = 0;
+    long allocs = allocCount().allocs;
+
+    for (size_t d = 0; d < demos.size(); d++)
+    {
+        for (int i = 1; i < demos[d].length(); i++)
+        {
+            model.predict(demos[d].prefix(i));
+            calls++;
+        }
+    }
+
+    allocs = allocCount().allocs - allocs;
+
+    printf("%-24s %8ld %12.3f %8ld %12.3f %12.3f\n", name, steady, steady ? (double) steadyAllocs / steady : 0.0,
+           growing, growing ? (double) growingAllocs / growing : 0.0, calls ? (double) allocs / calls : 0.0);
+}
+
+//micro-benchmark suite: every operation runs on fixtures built once from the trainingdata file
+
+typedef struct
+{
+    const char *path;
+    vector<EventSeq> demos;
+    vector<EventPair> pairs;
+    vector<string> a;           //decimal text of the pairs, for levDistance
+    vector<string> b;
+    vector<EventView> windows;  //the last MICROWINDOW events before every step of the demonstrations
+    PslModel model;             //trained on every demonstration
+    vector<double> scores;      //getConfScores output
+
+} MicroFixture;
+
+typedef struct
+{
+    const char *name;
+    long ops;
+    double ns;      //per operation
+    double allocs;  //per operation
+    double bytes;   //per operation
+
+} MicroResult;
+
+//runs op(fixture, i) for i in [0, ops) after a warm-up pass, repeating the pass until MICROTIME has elapsed
+MicroResult benchMicro(const char *name, void (*op)(MicroFixture &fixture, int i), MicroFixture &fixture, int ops)
+{
+    for (int i = 0; i < ops; i++)
+    {
+        op(fixture, i);
+    }
+
+    struct timespec start, end;
+    AllocCount before = allocCount();
+    long done = 0;
+    double ns = 0;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    while (ns < MICROTIME)
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            op(fixture, i);
+        }
+
+        done += ops;
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+        ns = elapsed_ns(end, start);
+    }
+
+    AllocCount after = allocCount();
+
+    MicroResult r;
+
+    r.name = name;
+    r.ops = done;
+    r.ns = ns / done;
+    r.allocs = (double) (after.allocs - before.allocs) / done;
+    r.bytes = (double) (after.bytes - before.bytes) / done;
+
+    return r;
+}
+
+void microLevDistance(MicroFixture &f, int i)
+{
+    levDistance(f.a[i], f.b[i]);
+}
+
+void microApproxmatch(MicroFixture &f, int i)
+{
+    hyp_approxmatch(f.pairs[i].a, f.pairs[i].b);
+}
+
+void microHypMatch(MicroFixture &f, int i)
+{
+    f.model.hypMatch(i % f.model.size(), f.windows[i % f.windows.size()]);
+}
+
+void microConfScores(MicroFixture &f, int i)
+{
+    f.model.getConfScores(f.windows[i], f.scores.data());
+}
+
+void microSelectHyp(MicroFixture &f, int i)
+{
+    f.model.selectHyp(f.windows[i]);
+}
+
+void microPredictTopK(MicroFixture &f, int i)
+{
+    static vector<Prediction> out;
+
+    f.model.predictTopK(f.windows[i], 5, out);
+}
+
+//one more demonstration trained into the full library
+void microTrain(MicroFixture &f, int i)
+{
+    f.model.train(f.demos[i], 0, f.demos[i].length() - 1);
+}
+
+//what hyptrain does without the application: init, read the trainingdata file and train every demonstration
+void microHyptrain(MicroFixture &f, int i)
+{
+    init();
+
+    TrainingData demos;
+    demos.load(f.path);
+
+    for (int d = 0; d < demos.size(); d++)
+    {
+        train(demos.demo(d), 0, demos.demo(d).length() - 1);
+    }
+}
+
+void printJsonString(const char *text)
+{
+    putchar('"');
+
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            putchar('\\');
+
+        putchar(*c);
+    }
+
+    putchar('"');
+}
+
+int runMicroSuite(const char *path)
+{
+    MicroFixture f;
+
+    f.path = path;
+    loadDemonstrations(path, f.demos);
+
+    if (f.demos.empty())
+    {
+        fprintf(stderr, "no demonstrations in %s\n", path);
+        return 1;
+    }
+
+    buildPairs(f.demos, f.pairs);
+
+    for (size_t i = 0; i < f.pairs.size(); i++)
+    {
+        f.a.push_back(eventString(f.pairs[i].a));
+        f.b.push_back(eventString(f.pairs[i].b));
+    }
+
+    for (size_t d = 0; d < f.demos.size(); d++)
+    {
+        for (int i = 1; i < f.demos[d].length(); i++)
+        {
+            f.windows.push_back(f.demos[d].view().window(max(0, i - MICROWINDOW), i));
+        }
+    }
+
+    for (size_t d = 0; d < f.demos.size(); d++)
+    {
+        f.model.train(f.demos[d], 0, f.demos[d].length() - 1);
+    }
+
+    f.scores.resize(f.model.size());
+
+    int hypotheses = f.model.size();
+
+    vector<MicroResult> results;
+
+    results.push_back(benchMicro("levDistance", microLevDistance, f, f.pairs.size()));
+    results.push_back(benchMicro("hyp_approxmatch", microApproxmatch, f, f.pairs.size()));
+    results.push_back(benchMicro("hypMatch", microHypMatch, f, f.windows.size()));
+    results.push_back(benchMicro("getConfScores", microConfScores, f, f.windows.size()));
+    results.push_back(benchMicro("selectHyp", microSelectHyp, f, f.windows.size()));
+    results.push_back(benchMicro("predictTopK (k = 5)", microPredictTopK, f, f.windows.size()));
+
+    //the library grows while these run, so the fixture model is only reused above
+    results.push_back(benchMicro("train (one demonstration)", microTrain, f, f.demos.size()));
+    results.push_back(benchMicro("hyptrain", microHyptrain, f, 1));
+
+    printf("{\n");
+    printf("  \"trainingdata\": ");
+    printJsonString(path);
+    printf(",\n");
+    printf("  \"demonstrations\": %d,\n", (int) f.demos.size());
+    printf("  \"hypotheses\": %d,\n", hypotheses);
+    printf("  \"kernel\": %d,\n", getMatchKernel());
+    printf("  \"benchmarks\": [\n");
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const MicroResult &r = results[i];
+
+        printf("    { \"name\": \"%s\", \"ops\": %ld, \"ns_per_op\": %.1f, \"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f }%s\n",
+            r.name, r.ops, r.ns, r.allocs, r.bytes, i + 1 < results.size() ? "," : "");
+    }
+
+    printf("  ]\n}\n");
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--verify") == 0)
+        return verifyBounded(argc - 2, argv + 2);
+
+    if (argc > 1 && strcmp(argv[1], "--json") == 0)
+        return runMicroSuite(argc > 2 ? argv[2] : DEFAULT_TRAININGDATA);
+
+    const char *path = argc > 1 ? argv[1] : DEFAULT_TRAININGDATA;
+
+    vector<EventSeq> demos;
+    loadDemonstrations(path, demos);
+
+    if (demos.empty())
+    {
+        printf("no demonstrations in %s\n", path);
+        return 1;
+    }
+
+    vector<EventPair> pairs;
+    buildPairs(demos, pairs);
+
+    printf("%d demonstrations, %d window pairs\n\n", (int) demos.size(), (int) pairs.size());
+
+    int stringMatches, nativeMatches;
+
+    double stringNs = benchKernel(hyp_approxmatch_string, pairs, 3, &stringMatches);
+    double nativeNs = benchKernel(hyp_approxmatch_native, pairs, 100, &nativeMatches);
+
+    printf("%-24s %12s %10s\n", "kernel", "ns/op", "matches");
+    printf("%-24s %12.1f %10d\n", "hyp_approxmatch_string", stringNs, stringMatches);
+    printf("%-24s %12.1f %10d\n", "hyp_approxmatch_native", nativeNs, nativeMatches);
+    printf("\nspeedup %.1fx\n", stringNs / nativeNs);
+
+    //approxmatch types on the decimal text of the same pairs, k = MATCHTOL
+
+    vector<string> as, bs;
+
+    for (size_t i = 0; i < pairs.size(); i++)
+    {
+        as.push_back(eventString(pairs[i].a));
+        bs.push_back(eventString(pairs[i].b));
+    }
+
+    const char *names[5] = {"exactmatch", "levDistanceBounded", "ukkonenwood", "galilpark", "bitparallel"};
+    int matches;
+
+    printf("\n%-24s %12s %10s\n", "approxmatch type", "ns/op", "matches");
+
+    double levNs = benchLevDistance(as, bs, -1, 3, &matches);
+    printf("%-24s %12.1f %10d\n", "levDistance (full)", levNs, matches);
+
+    levNs = benchLevDistance(as, bs, MATCHTOL, 20, &matches);
+    printf("%-24s %12.1f %10d\n", "levDistanceBounded", levNs, matches);
+
+    for (int type = 0; type < 5; type++)
+    {
+        double ns = benchApproxmatch(as, bs, type, 20, &matches);
+        printf("%d %-22s %12.1f %10d\n", type, names[type], ns, matches);
+    }
+
+    //full levDistance per instruction set on the long windows (16 events), the size of grown bodies
+
+    vector<string> al, bl;
+
+    for (size_t i = 0; i < pairs.size(); i++)
+    {
+        if (pairs[i].a.length() == 16)
+        {
+            al.push_back(as[i]);
+            bl.push_back(bs[i]);
+        }
+    }
+
+    const char *isas[3] = {"scalar", "sse4.1", "avx2"};
+
+    printf("\n%-24s %12s   (%d pairs of 16-event windows)\n", "levDistance", "Mcells/s", (int) al.size());
+    printf("%-24s %12.1f\n", "levDistance (reference)", benchLevIsa(al, bl, -1, 2) * 1e-6);
+
+    for (int isa = LEV_SCALAR; isa <= levDistanceIsaSupported(); isa++)
+    {
+        printf("%-24s %12.1f\n", isas[isa], benchLevIsa(al, bl, isa, 10) * 1e-6);
+    }
+
+    //predict latency with and without the hypothesis index, on a library trained from the same demonstrations
+
+    const int kernels[2] = {MATCH_NATIVE, MATCH_EXACT};
+    const char *kernelNames[2] = {"native", "exact"};
+    const char *indexNames[3] = {"none", "exact", "quantized/4"};
+
+    printf("\n%-24s %12s %12s %10s %10s\n", "predict (kernel, index)", "ns/op", "candidates", "hyps", "predicted");
+
+    for (int k = 0; k < 2; k++)
+    {
+        setMatchKernel(kernels[k]);
+        setHypIndexMode(HYPINDEX_EXACT, 1);
+        clearHypotheses();
+
+        for (size_t d = 0; d < demos.size(); d++)
+        {
+            train(demos[d], 0, demos[d].length() - 1);
+        }
+
+        for (int mode = HYPINDEX_NONE; mode <= HYPINDEX_QUANTIZED; mode++)
+        {
+            double candidates;
+            int predicted;
+
+            setHypIndexMode(mode, 4);
+
+            double ns = benchPredict(demos, 3, &candidates, &predicted);
+
+            string name = string(kernelNames[k]) + ", " + indexNames[mode];
+            printf("%-24s %12.1f %12.1f %10d %10d\n", name.c_str(), ns, candidates, getHypothesisCount(), predicted);
+        }
+
+        //the trie store against the flat scans above; it only serves the exact kernel
+        if (kernels[k] == MATCH_EXACT)
+        {
+            double candidates;
+            int predicted;
+
+            setHypStore(HYPSTORE_TRIE);
+
+            double ns = benchPredict(demos, 3, &candidates, &predicted);
+            printf("%-24s %12.1f %12.1f %10d %10d\n", "exact, trie", ns, candidates, getHypothesisCount(), predicted);
+
+            setHypStore(HYPSTORE_FLAT);
+        }
+    }
+
+    //training with parallel scoring, every hypothesis scored (no index) so passes are large enough to split
+
+    const int workers[4] = {1, 2, 4, 8};
+
+    setMatchKernel(MATCH_NATIVE);
+    setHypIndexMode(HYPINDEX_NONE, 1);
+
+    printf("\n%-24s %12s %10s   (%u hardware threads)\n", "train (native, no index)", "ms", "hyps", thread::hardware_concurrency());
+
+    for (int w = 0; w < 4; w++)
+    {
+        setWorkerCount(workers[w]);
+
+        double ms = benchTrain(demos);
+
+        printf("%-18s %5d %12.1f %10d\n", "workers", workers[w], ms, getHypothesisCount());
+    }
+
+    setWorkerCount(1);
+    setHypIndexMode(HYPINDEX_EXACT, 1);
+
+    //whole training run per kernel; the string kernel compares cached text (EventText)
+
+    const char *trainKernels[3] = {"string", "native", "exact"};
+
+    printf("\n%-24s %12s %10s\n", "train (kernel)", "ms", "hyps");
+
+    for (int kernel = MATCH_STRING; kernel <= MATCH_EXACT; kernel++)
+    {
+        setMatchKernel(kernel);
+
+        double ms = benchTrain(demos);
+
+        printf("%-24s %12.1f %10d\n", trainKernels[kernel], ms, getHypothesisCount());
+    }
+
+    setMatchKernel(MATCH_NATIVE);
+
+    //startup cost and footprint of the library
+
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+    init();
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    double initUs = elapsed_ns(end, start) * 1e-3;
+
+    benchTrain(demos);
+
+    const HypLibrary &library = getDefaultModel().getLibrary();
+
+    printf("\n%-24s %12.1f us\n", "init", initUs);
+    printf("%-24s %12d hypotheses, %d pool events, %.1f KB\n", "library", library.size(), library.events(), library.memoryUsage() / 1024.0);
+
+    //cold start to the first prediction: retraining against loading a snapshot of the same library,
+    //as the application does without new demonstrations
+
+    double trainMs = benchTrain(demos);
+
+    writeSnapshot(getDefaultModel(), SNAPSHOTPATH);
+
+    PslSnapshot snapshot;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    PslModel loaded(getDefaultModel().getConfig());
+
+    bool mapped = snapshot.open(SNAPSHOTPATH);
+    snapshot.copyTo(loaded);
+    EventItem first = loaded.predict(demos[0].prefix(1));
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    printf("\n%-24s %12s %12s\n", "cold start", "ms", "predicted");
+    printf("%-24s %12.1f %12d\n", "retrain", trainMs, predict(demos[0].prefix(1)).eventtype);
+    printf("%-24s %12.3f %12d\n", mapped ? "snapshot" : "snapshot (failed)", elapsed_ns(end, start) * 1e-6, first.eventtype);
+
+    snapshot.close();
+    remove(SNAPSHOTPATH);
+
+    //reading a multi-megabyte demonstration log: text and binary, both through TrainingData on the mapped file
+
+    long logBytes = writeLargeLog(path, LARGELOGPATH, LARGELOGCOPIES);
+
+    printf("\n%-24s %12s %12s %10s   (%.1f MB)\n", "load trainingdata", "ms", "MB/s", "demos", logBytes / 1e6);
+
+    {
+        TrainingData data;
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+        data.load(LARGELOGPATH);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+        double ms = elapsed_ns(end, start) * 1e-6;
+
+        printf("%-24s %12.1f %12.1f %10d\n", "TrainingData", ms, logBytes / (ms * 1e3), data.size());
+
+        //the same demonstrations written through DemoLogWriter in bursts, as the control loop would,
+        //pausing so the writer thread keeps up; then read back from the binary log
+        remove(BINARYLOGPATH);
+
+        DemoLogWriter writer;
+        writer.open(BINARYLOGPATH, DEMOLOG_BINARY);
+
+        double logNs = 0;
+        long logged = 0;
+
+        for (int i = 0; i < data.size(); i++)
+        {
+            EventView demo = data.demo(i);
+
+            for (int j = 0; j <= demo.length(); j++)
+            {
+                if (logged > 0 && logged % LOGBURST == 0)
+                    this_thread::sleep_for(chrono::milliseconds(10));
+
+                clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+                if (j < demo.length())
+                    writer.event(demo[j].event, demo[j].eventtype);
+                else
+                    writer.finish();
+
+                clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+                logNs += elapsed_ns(end, start);
+                logged++;
+            }
+        }
+
+        writer.close();
+
+        MappedFile binaryLog;
+        binaryLog.open(BINARYLOGPATH, MAPPED_SEQUENTIAL);
+        long binaryBytes = binaryLog.size();
+        binaryLog.close();
+
+        TrainingData binaryData;
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+        binaryData.load(BINARYLOGPATH);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+        ms = elapsed_ns(end, start) * 1e-6;
+
+        bool same = binaryData.size() == data.size() && binaryData.eventCount() == data.eventCount();
+
+        printf("%-24s %12.1f %12.1f %10d   (%.1f MB%s)\n", "binary log", ms, binaryBytes / (ms * 1e3), binaryData.size(),
+            binaryBytes / 1e6, same ? "" : ", differs");
+        printf("%-24s %12.1f ns/event %5ld dropped\n", "DemoLogWriter::event", logNs / logged, writer.dropped());
+    }
+
+    remove(LARGELOGPATH);
+    remove(BINARYLOGPATH);
+
+    //the same volume split over several files, parsed by TrainingCorpus on 1 and 4 threads.
+    //the files are copies of one log, so deduplication keeps a single copy of every demonstration
+
+    string corpusFiles;
+
+    for (int f = 0; f < CORPUSFILES; f++)
+    {
+        char corpusPath[64];
+        sprintf(corpusPath, CORPUSPATH, f);
+
+        writeLargeLog(path, corpusPath, LARGELOGCOPIES / CORPUSFILES);
+        corpusFiles += string(corpusPath) + " ";
+    }
+
+    printf("\n%-24s %12s %12s %10s %10s   (%d files)\n", "load corpus", "ms", "MB/s", "demos", "dups", CORPUSFILES);
+
+    int corpusThreads[] = { 1, 4 };
+
+    for (int t = 0; t < 2; t++)
+    {
+        TrainingCorpus corpus;
+        corpus.addFiles(corpusFiles.c_str());
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+        int kept = corpus.load(corpusThreads[t]);
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+        double ms = elapsed_ns(end, start) * 1e-6;
+
+        char name[32];
+        sprintf(name, "TrainingCorpus (%d thr)", corpusThreads[t]);
+
+        printf("%-24s %12.1f %12.1f %10d %10d\n", name, ms, logBytes / (ms * 1e3), kept, corpus.duplicates());
+    }
+
+    for (int f = 0; f < CORPUSFILES; f++)
+    {
+        char corpusPath[64];
+        sprintf(corpusPath, CORPUSPATH, f);
+
+        remove(corpusPath);
+    }
+
+    //loading the archived hypothesis dumps: getline + sscanf against parseHypotheses on mapped files
+
+    vector<string> dumps;
+    hypothesisFiles(path, dumps);
+
+    printf("\n%-24s %12s %12s %10s   (%d files)\n", "load hypotheses", "ms", "MB/s", "hyps", (int) dumps.size());
+
+    const int loadThreads[3] = {1, 1, 4};
+
+    for (int t = 0; t < 3; t++)
+    {
+        long hyps, bytes;
+
+        double ms = benchLoad(dumps, loadThreads[t], t == 0, &hyps, &bytes);
+
+        string name = t == 0 ? string("getline/sscanf") : "parser, threads " + to_string(loadThreads[t]);
+
+        printf("%-24s %12.1f %12.1f %10ld\n", name.c_str(), ms, bytes / (ms * 1e3), hyps);
+    }
+
+    //eviction: three passes over the demonstrations with the library capped at a third of its natural size
+
+    const char *policies[4] = {"none", "lru", "conf x support", "min support 3"};
+    int cap = library.size() / 3;
+
+    printf("\n%-24s %8s %10s %8s %10s %10s   (cap %d)\n", "eviction policy", "live", "evicted", "passes", "KB", "train ms", cap);
+
+    for (int policy = EVICT_NONE; policy <= EVICT_MINSUPPORT; policy++)
+    {
+        PslModel model;
+        model.setEvictionPolicy(policy, cap, 3);
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+        for (int r = 0; r < 3; r++)
+        {
+            for (size_t d = 0; d < demos.size(); d++)
+            {
+                model.train(demos[d], 0, demos[d].length() - 1);
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+        PslStats stats = model.getStats();
+
+        printf("%-24s %8d %10ld %8ld %10.1f %10.1f\n", policies[policy], stats.live, stats.evicted, stats.compactions, stats.bytes / 1024.0, elapsed_ns(end, start) * 1e-6);
+    }
+
+    //heap allocations per training step and per prediction
+
+    printf("\n%-24s %8s %12s %8s %12s %12s\n", "allocations (kernel)", "steps", "allocs/step", "growing", "allocs/step", "allocs/pred");
+
+    {
+        PslModel model;
+        model.setMatchKernel(MATCH_STRING);
+        benchAllocs(model, demos, "string");
+    }
+
+    {
+        PslModel model;
+        benchAllocs(model, demos, "native");
+    }
+
+    {
+        PslModel model;
+        model.setMatchKernel(MATCH_EXACT);
+        benchAllocs(model, demos, "exact");
+    }
+
+    {
+        PslModel model;
+        model.setMatchKernel(MATCH_EXACT);
+        model.setHypStore(HYPSTORE_TRIE);
+        benchAllocs(model, demos, "exact, trie");
+    }
+
+    return 0;
+}
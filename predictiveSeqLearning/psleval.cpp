@@ -0,0 +1,163 @@
+//leave-one-demonstration-out evaluation of PSL: for every demonstration of the corpus, trains on the
+//others and predicts each next event of the held-out one
+//usage: psleval [-c config] [-t threads] [-m accuracy] [trainingdata files]
+//       -c  readPslConfig file of the model (defaultPslConfig)
+//       -t  folds evaluated at once (1, so the latencies are not shared with other folds)
+//       -m  lowest top-1 accuracy accepted: below it psleval exits with 2, as a regression gate
+//the files (globs allowed) default to applicationData/1/trainingdata.txt
+
+#include <time.h>
+#include <unistd.h>
+#include "pslImplementation.h"
+#include "pslEval.h"
+
+#define DEFAULT_TRAININGDATA "../applicationData/1/trainingdata.txt"
+
+using namespace std;
+
+typedef struct
+{
+    const PslConfig *config;
+    const vector<EventView> *demos;
+    vector<PslEvalResult> *folds;
+    vector<vector<double> > *latencies;
+
+} EvalJob;
+
+int usage()
+{
+    fprintf(stderr, "usage: psleval [-c config] [-t threads] [-m accuracy] [trainingdata files]\n");
+
+    return 1;
+}
+
+void evalTask(void *context, int chunk)
+{
+    EvalJob &job = *(EvalJob *) context;
+
+    evaluateHeldOut(*job.config, *job.demos, chunk, (*job.folds)[chunk], &(*job.latencies)[chunk]);
+}
+
+//the latency below which a fraction p of the sorted latencies lie
+double percentile(const vector<double> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+
+    size_t i = (size_t) (p * (sorted.size() - 1) + 0.5);
+
+    return sorted[i];
+}
+
+int main(int argc, char **argv)
+{
+    PslConfig config = defaultPslConfig();
+    int threads = 1;
+    double minAccuracy = -1;
+
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:t:m:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            if (readPslConfig(optarg, config) < 0)
+            {
+                fprintf(stderr, "can't read %s as a PSL configuration\n", optarg);
+                return 1;
+            }
+            break;
+        case 't': threads = max(1, atoi(optarg)); break;
+        case 'm': minAccuracy = atof(optarg); break;
+        default: return usage();
+        }
+    }
+
+    //the folds are the parallel work, a model scores on one thread
+    config.workers = 1;
+
+    TrainingCorpus corpus;
+
+    if (optind == argc)
+        corpus.addFile(DEFAULT_TRAININGDATA);
+
+    for (int i = optind; i < argc; i++)
+    {
+        corpus.addFiles(argv[i]);
+    }
+
+    //files that can't be read are reported and left out
+    int kept = corpus.load(threads);
+
+    corpus.printFailures(stderr);
+
+    if (kept < 0)
+        return 1;
+
+    if (corpus.size() < 2)
+    {
+        fprintf(stderr, "%d demonstrations, leaving one out needs at least 2\n", corpus.size());
+        return 1;
+    }
+
+    vector<EventView> demos;
+
+    for (int i = 0; i < corpus.size(); i++)
+    {
+        demos.push_back(corpus.demo(i));
+    }
+
+    vector<PslEvalResult> folds(demos.size());
+    vector<vector<double> > latencies(demos.size());
+
+    EvalJob job = { &config, &demos, &folds, &latencies };
+
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    ThreadPool pool;
+    pool.resize(threads);
+    pool.run(demos.size(), evalTask, &job);
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    PslEvalResult total;
+    clearEvalResult(total);
+
+    vector<double> all;
+
+    for (size_t f = 0; f < folds.size(); f++)
+    {
+        addEvalResult(total, folds[f]);
+        all.insert(all.end(), latencies[f].begin(), latencies[f].end());
+    }
+
+    sort(all.begin(), all.end());
+
+    double predictions = max(1L, total.predictions);
+    double accuracy = total.correct / predictions;
+
+    printf("%d demonstrations (%d duplicates dropped), %d folds on %d threads, %.1f s\n\n", (int) demos.size(),
+        corpus.duplicates(), total.folds, threads, elapsed_ns(end, start) * 1e-9);
+
+    printPslConfig(config, stdout);
+
+    printf("\n%-24s %12ld\n", "predictions", total.predictions);
+    printf("%-24s %12.3f\n", "top-1 accuracy", accuracy);
+    printf("%-24s %12.3f\n", "coverage", total.covered / predictions);
+    printf("%-24s %12.1f\n", "predict p50 us", percentile(all, 0.50) * 1e-3);
+    printf("%-24s %12.1f\n", "predict p90 us", percentile(all, 0.90) * 1e-3);
+    printf("%-24s %12.1f\n", "predict p99 us", percentile(all, 0.99) * 1e-3);
+    printf("%-24s %12.1f\n", "predict max us", all.empty() ? 0.0 : all.back() * 1e-3);
+    printf("%-24s %12.0f\n", "train events/s", total.trainNs > 0 ? total.trainEvents / (total.trainNs * 1e-9) : 0.0);
+
+    if (accuracy < minAccuracy)
+    {
+        printf("\naccuracy below %.3f\n", minAccuracy);
+        return 2;
+    }
+
+    return 0;
+}
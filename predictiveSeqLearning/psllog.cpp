@@ -0,0 +1,85 @@
+//converts demonstration logs between the trainingdata text format and binary logs
+//usage: psllog tobin trainingdata.txt demos.log
+//       psllog totext demos.log trainingdata.txt
+//either input format is accepted; text has no time stamps, converted records are stamped 0
+
+#include <string.h>
+#include "pslImplementation.h"
+
+using namespace std;
+
+int usage()
+{
+    fprintf(stderr, "usage: psllog tobin trainingdata.txt demos.log\n       psllog totext demos.log trainingdata.txt\n");
+
+    return 1;
+}
+
+int convert(const char *inPath, const char *outPath, int format)
+{
+    TrainingData demos;
+
+    if (demos.load(inPath) < 0)
+    {
+        fprintf(stderr, "can't read %s\n", inPath);
+        return 1;
+    }
+
+    FILE *outFile = fopen(outPath, "wb");
+
+    if (outFile == NULL)
+    {
+        fprintf(stderr, "can't write %s\n", outPath);
+        return 1;
+    }
+
+    if (format == DEMOLOG_BINARY)
+        writeDemoLogHeader(outFile);
+
+    vector<DemoLogRecord> records;
+
+    for (int i = 0; i < demos.size(); i++)
+    {
+        EventView demo = demos.demo(i);
+
+        records.assign(demo.length() + 1, DemoLogRecord());
+
+        for (int j = 0; j < demo.length(); j++)
+        {
+            records[j].event = demo[j].event;
+            records[j].type = demo[j].eventtype;
+        }
+
+        records.back().type = DEMOLOG_FINISH;
+
+        writeDemoRecords(outFile, format, records.data(), records.size());
+    }
+
+    bool failed = ferror(outFile);
+
+    fclose(outFile);
+
+    if (failed)
+    {
+        fprintf(stderr, "can't write %s\n", outPath);
+        return 1;
+    }
+
+    printf("%d demonstrations, %d events\n", demos.size(), demos.eventCount());
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+        return usage();
+
+    if (strcmp(argv[1], "tobin") == 0)
+        return convert(argv[2], argv[3], DEMOLOG_BINARY);
+
+    if (strcmp(argv[1], "totext") == 0)
+        return convert(argv[2], argv[3], DEMOLOG_TEXT);
+
+    return usage();
+}
@@ -0,0 +1,81 @@
+//converts hypothesis libraries between the print_hypotheses text format and binary snapshots
+//usage: pslsnap tobin hypotheses.txt snapshot.psl
+//       pslsnap totext snapshot.psl hypotheses.txt
+
+#include <string.h>
+#include "pslImplementation.h"
+
+using namespace std;
+
+int usage()
+{
+    fprintf(stderr, "usage: pslsnap tobin hypotheses.txt snapshot.psl\n       pslsnap totext snapshot.psl hypotheses.txt\n");
+
+    return 1;
+}
+
+int toBinary(const char *textPath, const char *snapshotPath)
+{
+    PslModel model;
+
+    int count = loadHypothesisFile(textPath, model);
+
+    if (count < 0)
+    {
+        fprintf(stderr, "can't read %s as a print_hypotheses file\n", textPath);
+        return 1;
+    }
+
+    if (writeSnapshot(model, snapshotPath) != 0)
+    {
+        fprintf(stderr, "can't write %s\n", snapshotPath);
+        return 1;
+    }
+
+    printf("%d hypotheses\n", count);
+
+    return 0;
+}
+
+int toText(const char *snapshotPath, const char *textPath)
+{
+    PslSnapshot snapshot;
+
+    if (!snapshot.open(snapshotPath))
+    {
+        fprintf(stderr, "%s is not a snapshot of version %d\n", snapshotPath, PSLSNAPSHOT_VERSION);
+        return 1;
+    }
+
+    PslModel model;
+    snapshot.copyTo(model);
+
+    FILE *outFile = fopen(textPath, "w");
+
+    if (outFile == NULL)
+    {
+        fprintf(stderr, "can't write %s\n", textPath);
+        return 1;
+    }
+
+    model.print_hypotheses(outFile);
+    fclose(outFile);
+
+    printf("%d hypotheses\n", model.size());
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+        return usage();
+
+    if (strcmp(argv[1], "tobin") == 0)
+        return toBinary(argv[2], argv[3]);
+
+    if (strcmp(argv[1], "totext") == 0)
+        return toText(argv[2], argv[3]);
+
+    return usage();
+}
@@ -0,0 +1,324 @@
+//trains a grid of PSL configurations on one corpus and writes a hypothesis dump and metrics per cell
+//usage: pslsweep [-c config] [-d demos] [-a kernels] [-q quanta] [-k tolerance] [-t threads] [-o dir] [trainingdata files]
+//       -c  readPslConfig file the cells start from (defaultPslConfig)
+//       -d  comma separated numbers of training demonstrations, the first N of the corpus (5,10,15,21)
+//       -a  comma separated hyp_approxmatch kernels, MATCH_STRING 0, MATCH_NATIVE 1, MATCH_EXACT 2 (0,1,2)
+//       -q  comma separated observation quantizations: the differences of every observation are scaled by
+//           q / 20 before training, so 20 trains on the recorded values and 10 halves them, the scaling
+//           applicationData/1/trainingdata2.txt was made with (10,20)
+//       -k  tolerance of the approximate kernels (that of the configuration)
+//       -t  threads (hardware threads)
+//       -o  directory of the dumps, named hypotheses_<demos>_a<kernel>_q<quantum>.txt (.)
+//the files (globs allowed) default to applicationData/1/trainingdata.txt.
+//the grid follows the naming of the dumps archived in applicationData/1, but those were made by earlier code:
+//no setting of this tool reproduces them.
+
+#include <time.h>
+#include <unistd.h>
+#include <thread>
+#include "pslImplementation.h"
+#include "pslEval.h"
+
+#define DEFAULT_TRAININGDATA "../applicationData/1/trainingdata.txt"
+#define QUANTUMBASE 20 //quantization the observations are recorded at
+
+using namespace std;
+
+typedef struct
+{
+    int demos;
+    int kernel;
+    int quantum;
+    int corpus; //index of the corpus quantized by quantum
+
+} SweepCell;
+
+//one task of the sweep: the full training of a cell (fold -1) or one held-out demonstration of it
+typedef struct
+{
+    int cell;
+    int fold;
+
+} SweepTask;
+
+typedef struct
+{
+    const vector<SweepCell> *cells;
+    const vector<SweepTask> *tasks;
+    const vector<vector<EventView> > *corpora; //the corpus quantized for every quantum
+    const PslConfig *base;
+    int tolerance;
+    const char *outDir;
+
+    vector<PslEvalResult> *folds; //result of every task, by task
+    vector<double> *trainMs;      //by cell
+    vector<int> *hypotheses;      //by cell
+    vector<int> *written;         //by cell, 1 if the dump was written
+
+} SweepJob;
+
+int usage()
+{
+    fprintf(stderr, "usage: pslsweep [-c config] [-d demos] [-a kernels] [-q quanta] [-k tolerance] [-t threads] [-o dir] [trainingdata files]\n");
+
+    return 1;
+}
+
+//copy of demo whose observation differences are scaled by quantum / QUANTUMBASE, truncated as the
+//integer division of the recorded values would be. actions and the grasp are kept
+void quantizeDemo(EventView demo, int quantum, EventSeq &out)
+{
+    out.assign(demo);
+
+    for (int i = 0; i < out.length(); i++)
+    {
+        if (out[i].eventtype != 2)
+            continue;
+
+        signed char *f = (signed char *) &out[i].event.observation;
+
+        for (int j = 0; j < 4; j++)
+        {
+            int v = f[j] * quantum / QUANTUMBASE;
+
+            f[j] = (signed char) max(-128, min(127, v));
+        }
+    }
+}
+
+//comma separated non-negative integers
+bool parseList(const char *text, vector<int> &values)
+{
+    values.clear();
+
+    while (*text != '\0')
+    {
+        char *end;
+        long v = strtol(text, &end, 10);
+
+        if (end == text || v < 0)
+            return false;
+
+        values.push_back(v);
+
+        text = *end == ',' ? end + 1 : end;
+
+        if (*end != ',' && *end != '\0')
+            return false;
+    }
+
+    return !values.empty();
+}
+
+PslConfig cellConfig(const PslConfig &base, const SweepCell &cell, int tolerance)
+{
+    PslConfig config = base;
+
+    config.matchKernel = cell.kernel;
+    config.matchTol = tolerance;
+    config.workers = 1; //the sweep runs the cells in parallel instead
+
+    return config;
+}
+
+void sweepTask(void *context, int chunk)
+{
+    SweepJob &job = *(SweepJob *) context;
+
+    const SweepTask &task = (*job.tasks)[chunk];
+    const SweepCell &cell = (*job.cells)[task.cell];
+
+    //the first cell.demos demonstrations of the shared corpus at the quantization of the cell, read only
+    const vector<EventView> &corpus = (*job.corpora)[cell.corpus];
+    vector<EventView> demos(corpus.begin(), corpus.begin() + cell.demos);
+
+    PslConfig config = cellConfig(*job.base, cell, job.tolerance);
+
+    if (task.fold >= 0)
+    {
+        evaluateHeldOut(config, demos, task.fold, (*job.folds)[chunk], NULL);
+        return;
+    }
+
+    PslModel model(config);
+
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    for (size_t i = 0; i < demos.size(); i++)
+    {
+        model.train(demos[i], 0, demos[i].length() - 1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    (*job.trainMs)[task.cell] = elapsed_ns(end, start) * 1e-6;
+    (*job.hypotheses)[task.cell] = model.size();
+
+    string path = string(job.outDir) + "/hypotheses_" + to_string(cell.demos) + "_a" + to_string(cell.kernel) + "_q" + to_string(cell.quantum) + ".txt";
+
+    FILE *outFile = fopen(path.c_str(), "w");
+
+    if (outFile == NULL)
+        return;
+
+    model.print_hypotheses(outFile);
+    fclose(outFile);
+
+    (*job.written)[task.cell] = 1;
+}
+
+int main(int argc, char **argv)
+{
+    vector<int> demoCounts = { 5, 10, 15, 21 };
+    vector<int> kernels = { MATCH_STRING, MATCH_NATIVE, MATCH_EXACT };
+    vector<int> quanta = { 10, 20 };
+    PslConfig base = defaultPslConfig();
+    int tolerance = -1;
+    int threads = max(1, (int) thread::hardware_concurrency());
+    const char *outDir = ".";
+
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:d:a:q:k:t:o:")) != -1)
+    {
+        bool ok = true;
+
+        switch (opt)
+        {
+        case 'c': ok = readPslConfig(optarg, base) == 0; break;
+        case 'd': ok = parseList(optarg, demoCounts); break;
+        case 'a': ok = parseList(optarg, kernels); break;
+        case 'q': ok = parseList(optarg, quanta); break;
+        case 'k': tolerance = atoi(optarg); break;
+        case 't': threads = max(1, atoi(optarg)); break;
+        case 'o': outDir = optarg; break;
+        default: ok = false;
+        }
+
+        if (!ok)
+            return usage();
+    }
+
+    if (tolerance < 0)
+        tolerance = base.matchTol;
+
+    for (size_t i = 0; i < kernels.size(); i++)
+    {
+        if (kernels[i] > MATCH_EXACT)
+            return usage();
+    }
+
+    for (size_t q = 0; q < quanta.size(); q++)
+    {
+        if (quanta[q] == 0)
+            return usage();
+    }
+
+    TrainingCorpus corpus;
+
+    if (optind == argc)
+        corpus.addFile(DEFAULT_TRAININGDATA);
+
+    for (int i = optind; i < argc; i++)
+    {
+        corpus.addFiles(argv[i]);
+    }
+
+    //files that can't be read are reported and left out
+    int kept = corpus.load(threads);
+
+    corpus.printFailures(stderr);
+
+    if (kept < 0)
+        return 1;
+
+    //the corpus at every quantization, built once and shared by the cells
+    vector<vector<EventSeq> > quantized(quanta.size(), vector<EventSeq>(corpus.size()));
+    vector<vector<EventView> > corpora(quanta.size());
+
+    for (size_t q = 0; q < quanta.size(); q++)
+    {
+        for (int i = 0; i < corpus.size(); i++)
+        {
+            quantizeDemo(corpus.demo(i), quanta[q], quantized[q][i]);
+            corpora[q].push_back(quantized[q][i]);
+        }
+    }
+
+    //the grid, and a task for the full training and every held-out demonstration of each cell.
+    //tasks are handed out one at a time, so idle threads keep taking work until the grid is done.
+    vector<SweepCell> cells;
+    vector<SweepTask> tasks;
+
+    for (size_t d = 0; d < demoCounts.size(); d++)
+    {
+        for (size_t a = 0; a < kernels.size(); a++)
+        {
+            for (size_t q = 0; q < quanta.size(); q++)
+            {
+                SweepCell cell = { min(demoCounts[d], corpus.size()), kernels[a], quanta[q], (int) q };
+
+                for (int fold = -1; fold < cell.demos; fold++)
+                {
+                    SweepTask task = { (int) cells.size(), fold };
+                    tasks.push_back(task);
+                }
+
+                cells.push_back(cell);
+            }
+        }
+    }
+
+    vector<PslEvalResult> folds(tasks.size());
+    vector<double> trainMs(cells.size(), 0);
+    vector<int> hypotheses(cells.size(), 0);
+    vector<int> written(cells.size(), 0);
+
+    SweepJob job = { &cells, &tasks, &corpora, &base, tolerance, outDir, &folds, &trainMs, &hypotheses, &written };
+
+    for (size_t t = 0; t < tasks.size(); t++)
+    {
+        clearEvalResult(folds[t]);
+    }
+
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &start);
+
+    ThreadPool pool;
+    pool.resize(threads);
+    pool.run(tasks.size(), sweepTask, &job);
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end);
+
+    printf("%d demonstrations (%d duplicates dropped), %d cells, %d tasks on %d threads, %.1f s\n\n", corpus.size(),
+        corpus.duplicates(), (int) cells.size(), (int) tasks.size(), threads, elapsed_ns(end, start) * 1e-9);
+
+    printf("%6s %6s %6s %10s %8s %10s %10s %8s\n", "demos", "kernel", "q", "train ms", "hyps", "accuracy", "coverage", "preds");
+
+    int status = 0;
+
+    for (size_t c = 0; c < cells.size(); c++)
+    {
+        PslEvalResult total;
+        clearEvalResult(total);
+
+        for (size_t t = 0; t < tasks.size(); t++)
+        {
+            if (tasks[t].cell == (int) c)
+                addEvalResult(total, folds[t]);
+        }
+
+        double predictions = max(1L, total.predictions);
+
+        printf("%6d %6d %6d %10.1f %8d %10.3f %10.3f %8ld%s\n", cells[c].demos, cells[c].kernel, cells[c].quantum, trainMs[c],
+            hypotheses[c], total.correct / predictions, total.covered / predictions, total.predictions, written[c] ? "" : "  (dump not written)");
+
+        if (!written[c])
+            status = 1;
+    }
+
+    return status;
+}
@@ -0,0 +1,106 @@
+#ifndef TEXTSCANNER_H
+#define TEXTSCANNER_H
+
+#include <limits.h>
+
+//hand-rolled scanning of the text files of the library (trainingdata, print_hypotheses):
+//integers are read straight from the buffer without sscanf or iostream
+
+//cursor over the text being parsed
+typedef struct
+{
+    const char *p;
+    const char *end;
+
+} Scanner;
+
+inline void skipBlanks(Scanner &s)
+{
+    while (s.p < s.end && (*s.p == ' ' || *s.p == '\t'))
+        s.p++;
+}
+
+//moves past the end of the current line
+inline void nextLine(Scanner &s)
+{
+    while (s.p < s.end && *s.p != '\n')
+        s.p++;
+
+    if (s.p < s.end)
+        s.p++;
+}
+
+//true if p ends a word: the end of the text, a blank or the end of the line
+inline bool wordEnd(const Scanner &s, const char *p)
+{
+    return p == s.end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n';
+}
+
+//false if no digits follow, or if the number does not fit an int
+inline bool scanInt(Scanner &s, int &value)
+{
+    skipBlanks(s);
+
+    bool negative = false;
+
+    if (s.p < s.end && (*s.p == '-' || *s.p == '+'))
+        negative = *s.p++ == '-';
+
+    if (s.p == s.end || *s.p < '0' || *s.p > '9')
+        return false;
+
+    //accumulated negatively, so INT_MIN is in range
+    int v = 0;
+
+    while (s.p < s.end && *s.p >= '0' && *s.p <= '9')
+    {
+        int digit = *s.p++ - '0';
+
+        if (v < (INT_MIN + digit) / 10)
+            return false;
+
+        v = v * 10 - digit;
+    }
+
+    if (!negative && v == INT_MIN)
+        return false;
+
+    value = negative ? v : -v;
+
+    return true;
+}
+
+//consumes word if the text continues with it as a whole word, followed by a blank or the end of the line
+inline bool scanWord(Scanner &s, const char *word)
+{
+    skipBlanks(s);
+
+    const char *p = s.p;
+
+    for (; *word != '\0'; word++, p++)
+    {
+        if (p == s.end || *p != *word)
+            return false;
+    }
+
+    if (!wordEnd(s, p))
+        return false;
+
+    s.p = p;
+
+    return true;
+}
+
+//true if only blanks are left on the line
+inline bool blankLine(const Scanner &s)
+{
+    for (const char *p = s.p; p < s.end && *p != '\n'; p++)
+    {
+        if (*p != ' ' && *p != '\t' && *p != '\r')
+            return false;
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include "threadPool.h"
+
+ThreadPool::ThreadPool()
+{
+    task = NULL;
+    context = NULL;
+    chunks = 0;
+    next = 0;
+    active = 0;
+    generation = 0;
+    stop = false;
+    busy = false;
+}
+
+ThreadPool::~ThreadPool()
+{
+    stopWorkers();
+}
+
+void ThreadPool::stopWorkers()
+{
+    {
+        unique_lock<mutex> guard(lock);
+        stop = true;
+    }
+
+    wake.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    workers.clear();
+    stop = false;
+}
+
+void ThreadPool::resize(int threads)
+{
+    if (threads < 1)
+        threads = 1;
+
+    if (threads == size())
+        return;
+
+    stopWorkers();
+
+    for (int i = 1; i < threads; i++)
+    {
+        workers.push_back(thread(&ThreadPool::work, this));
+    }
+}
+
+void ThreadPool::drain()
+{
+    for (int c = next++; c < chunks; c = next++)
+    {
+        task(context, c);
+    }
+}
+
+void ThreadPool::work()
+{
+    unsigned seen = 0;
+
+    unique_lock<mutex> guard(lock);
+
+    while (true)
+    {
+        wake.wait(guard, [&] { return stop || generation != seen; });
+
+        if (stop)
+            return;
+
+        seen = generation;
+
+        guard.unlock();
+        drain();
+        guard.lock();
+
+        if (--active == 0)
+            finished.notify_one();
+    }
+}
+
+void ThreadPool::run(int chunks, void (*task)(void *context, int chunk), void *context)
+{
+    if (workers.empty() || chunks <= 1 || busy.exchange(true))
+    {
+        for (int c = 0; c < chunks; c++)
+        {
+            task(context, c);
+        }
+
+        return;
+    }
+
+    {
+        unique_lock<mutex> guard(lock);
+
+        this->task = task;
+        this->context = context;
+        this->chunks = chunks;
+        next = 0;
+        active = workers.size();
+        generation++;
+    }
+
+    wake.notify_all();
+
+    drain();
+
+    unique_lock<mutex> guard(lock);
+    finished.wait(guard, [&] { return active == 0; });
+
+    this->task = NULL;
+    this->context = NULL;
+
+    busy = false;
+}
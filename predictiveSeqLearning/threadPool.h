@@ -0,0 +1,58 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//fixed pool of worker threads running one chunked job at a time.
+//the calling thread takes part in every job, so a pool of size 1 has no worker threads and runs serially.
+//run() is reentrant: while the workers are busy with a job, other callers (and tasks of the job itself)
+//run their chunks serially on their own thread instead of waiting.
+
+class ThreadPool
+{
+public:
+    ThreadPool();
+
+    ~ThreadPool();
+
+    //total number of threads working on a job, the caller included
+    void resize(int threads);
+
+    int size() const { return (int) workers.size() + 1; }
+
+    //runs task(context, c) for every chunk c in [0, chunks) and returns once all of them are done.
+    //chunks are handed out dynamically; a task must only write state owned by its chunk.
+    //a plain function and context pointer keep jobs free of allocations.
+    void run(int chunks, void (*task)(void *context, int chunk), void *context);
+
+private:
+    void work();
+
+    void drain();
+
+    void stopWorkers();
+
+    vector<thread> workers;
+
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+
+    void (*task)(void *context, int chunk);
+    void *context;
+    int chunks;
+    atomic<int> next;
+    int active;
+    unsigned generation;
+    bool stop;
+
+    atomic<bool> busy; //a job owns the workers
+};
+
+#endif
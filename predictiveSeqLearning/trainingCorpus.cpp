@@ -0,0 +1,251 @@
+#include <glob.h>
+#include <string.h>
+#include <random>
+#include <unordered_map>
+#include "trainingCorpus.h"
+#include "threadPool.h"
+
+//FNV-1a over the bytes of the events
+static uint64_t demoHash(EventView demo)
+{
+    const unsigned char *p = (const unsigned char *) demo.items;
+    size_t n = demo.length() * sizeof(EventItem);
+
+    uint64_t h = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        h = (h ^ p[i]) * 1099511628211ULL;
+    }
+
+    return h;
+}
+
+static bool sameDemo(EventView a, EventView b)
+{
+    return a.length() == b.length() && memcmp(a.items, b.items, a.length() * sizeof(EventItem)) == 0;
+}
+
+TrainingCorpus::TrainingCorpus()
+{
+    orderMode = CORPUS_FILES;
+    seed = 0;
+    dedup = true;
+    dropped = 0;
+}
+
+void TrainingCorpus::addFile(const string &path)
+{
+    paths.push_back(path);
+}
+
+int TrainingCorpus::addFiles(const char *list)
+{
+    int added = 0;
+
+    const char *p = list;
+
+    while (*p != '\0')
+    {
+        while (*p == ' ')
+            p++;
+
+        const char *end = p;
+
+        while (*end != '\0' && *end != ' ')
+            end++;
+
+        if (end == p)
+            break;
+
+        string pattern(p, end - p);
+        p = end;
+
+        glob_t matches;
+
+        int result = glob(pattern.c_str(), 0, NULL, &matches);
+        bool wildcard = pattern.find_first_of("*?[") != string::npos;
+
+        if (result == GLOB_NOMATCH && wildcard)
+        {
+            patterns.push_back(pattern);
+            globfree(&matches);
+            continue;
+        }
+
+        //a missing path without wildcards, or a directory that can't be read: added as it is, it fails
+        //to load and is reported with the unreadable files
+        if (result != 0)
+        {
+            addFile(pattern);
+            added++;
+            globfree(&matches);
+            continue;
+        }
+
+        for (size_t i = 0; i < matches.gl_pathc; i++)
+        {
+            addFile(matches.gl_pathv[i]);
+            added++;
+        }
+
+        globfree(&matches);
+    }
+
+    return added;
+}
+
+void TrainingCorpus::setOrder(int order, unsigned seed)
+{
+    orderMode = order;
+    this->seed = seed;
+}
+
+void TrainingCorpus::loadTask(void *context, int chunk)
+{
+    TrainingCorpus &corpus = *(TrainingCorpus *) context;
+
+    TrainingData &file = corpus.data[chunk];
+
+    file.clear();
+    corpus.counts[chunk] = file.load(corpus.paths[chunk].c_str());
+
+    vector<uint64_t> &h = corpus.hashes[chunk];
+
+    h.resize(file.size());
+
+    for (int d = 0; d < file.size(); d++)
+    {
+        h[d] = demoHash(file.demo(d));
+    }
+}
+
+void TrainingCorpus::collect(vector<DemoRef> &kept)
+{
+    kept.clear();
+    dropped = 0;
+
+    unordered_map<uint64_t, vector<DemoRef> > seen;
+
+    for (int f = 0; f < files(); f++)
+    {
+        for (int d = 0; d < data[f].size(); d++)
+        {
+            DemoRef ref = { f, d };
+
+            if (dedup)
+            {
+                vector<DemoRef> &same = seen[hashes[f][d]];
+                bool duplicate = false;
+
+                for (size_t i = 0; i < same.size() && !duplicate; i++)
+                {
+                    duplicate = sameDemo(data[same[i].file].demo(same[i].demo), data[f].demo(d));
+                }
+
+                if (duplicate)
+                {
+                    dropped++;
+                    continue;
+                }
+
+                same.push_back(ref);
+            }
+
+            kept.push_back(ref);
+        }
+    }
+}
+
+int TrainingCorpus::load(int threads)
+{
+    data.assign(paths.size(), TrainingData());
+    hashes.assign(paths.size(), vector<uint64_t>());
+    counts.assign(paths.size(), -1);
+
+    //every file is parsed into its own buffer, so the tasks share nothing
+    ThreadPool pool;
+    pool.resize(threads);
+    pool.run(paths.size(), loadTask, this);
+
+    vector<DemoRef> kept;
+    collect(kept);
+
+    order.clear();
+    order.reserve(kept.size());
+
+    if (orderMode == CORPUS_INTERLEAVE)
+    {
+        //kept is grouped by file: take one demonstration of every file per round
+        vector<size_t> next(files(), kept.size());
+
+        for (size_t i = kept.size(); i-- > 0;)
+        {
+            next[kept[i].file] = i;
+        }
+
+        vector<size_t> end(files(), 0);
+
+        for (size_t i = 0; i < kept.size(); i++)
+        {
+            end[kept[i].file] = i + 1;
+        }
+
+        while (order.size() < kept.size())
+        {
+            for (int f = 0; f < files(); f++)
+            {
+                if (next[f] < end[f])
+                    order.push_back(kept[next[f]++]);
+            }
+        }
+    }
+    else
+    {
+        order = kept;
+
+        if (orderMode == CORPUS_SHUFFLE)
+        {
+            //Fisher-Yates on mt19937, whose sequence is fixed by the standard
+            mt19937 random(seed);
+
+            for (size_t i = order.size(); i > 1; i--)
+            {
+                size_t j = random() % i;
+                swap(order[i - 1], order[j]);
+            }
+        }
+    }
+
+    if (failedFiles() == files())
+        return -1;
+
+    return size();
+}
+
+int TrainingCorpus::failedFiles() const
+{
+    int failed = 0;
+
+    for (size_t f = 0; f < counts.size(); f++)
+    {
+        if (counts[f] < 0)
+            failed++;
+    }
+
+    return failed;
+}
+
+void TrainingCorpus::printFailures(FILE *out) const
+{
+    for (size_t f = 0; f < counts.size(); f++)
+    {
+        if (counts[f] < 0)
+            fprintf(out, "can't read %s\n", paths[f].c_str());
+    }
+
+    for (size_t i = 0; i < patterns.size(); i++)
+    {
+        fprintf(out, "%s matches no file\n", patterns[i].c_str());
+    }
+}
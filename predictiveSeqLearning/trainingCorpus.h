@@ -0,0 +1,96 @@
+#ifndef TRAININGCORPUS_H
+#define TRAININGCORPUS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "eventSeq.h"
+#include "trainingData.h"
+
+using namespace std;
+
+//training orders of a corpus. every order is a function of the file list (and the seed) only,
+//never of which file finished parsing first
+#define CORPUS_FILES 0      //the files in list order, the demonstrations of a file in its order (default)
+#define CORPUS_INTERLEAVE 1 //the first demonstration of every file, then the second of every file, ...
+#define CORPUS_SHUFFLE 2    //a permutation drawn from the seed
+
+//demonstrations of several trainingdata files or binary logs. the files are parsed in parallel, one
+//per thread, identical demonstrations are kept once (the first in CORPUS_FILES order) and the rest
+//are handed out in the training order.
+
+class TrainingCorpus
+{
+public:
+    TrainingCorpus();
+
+    //adds the files of a space separated list of paths and glob patterns, each pattern expanded in
+    //sorted order; returns the files added. a wildcard pattern matching no file adds nothing and is kept
+    //in unmatched, a missing path without wildcards is added and fails to load
+    int addFiles(const char *list);
+
+    void addFile(const string &path);
+
+    void setOrder(int order, unsigned seed);
+
+    void setDedup(bool dedup) { this->dedup = dedup; }
+
+    //parses every file on up to threads threads and orders the demonstrations of the files that could be
+    //read. returns how many are kept, or -1 if no file could be read
+    int load(int threads);
+
+    int files() const { return (int) paths.size(); }
+
+    const string &path(int f) const { return paths[f]; }
+
+    //demonstrations read from file f, -1 if it couldn't be read
+    int fileDemos(int f) const { return counts[f]; }
+
+    //files that couldn't be read by the last load
+    int failedFiles() const;
+
+    //patterns of addFiles that matched no file
+    int unmatched() const { return (int) patterns.size(); }
+
+    const string &unmatchedPattern(int i) const { return patterns[i]; }
+
+    //one line per unreadable file and per pattern that matched no file
+    void printFailures(FILE *out) const;
+
+    //demonstrations dropped as duplicates
+    int duplicates() const { return dropped; }
+
+    //demonstrations in training order
+    int size() const { return (int) order.size(); }
+
+    //view of the i-th demonstration of the training order, valid until the next load
+    EventView demo(int i) const { return data[order[i].file].demo(order[i].demo); }
+
+private:
+    typedef struct
+    {
+        int file;
+        int demo;
+
+    } DemoRef;
+
+    //kept demonstrations in CORPUS_FILES order, without duplicates
+    void collect(vector<DemoRef> &kept);
+
+    static void loadTask(void *context, int chunk);
+
+    vector<string> paths;
+    vector<string> patterns; //unmatched
+    vector<TrainingData> data;
+    vector<vector<uint64_t> > hashes; //hash of every demonstration of a file
+    vector<int> counts;
+
+    vector<DemoRef> order;
+    int orderMode;
+    unsigned seed;
+    bool dedup;
+    int dropped;
+};
+
+#endif
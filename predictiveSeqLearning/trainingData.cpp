@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include "trainingData.h"
+#include "demoLog.h"
+#include "mappedFile.h"
+#include "textScanner.h"
+
+void TrainingData::clear()
+{
+    events.clear();
+    starts.resize(1);
+}
+
+int TrainingData::parse(const char *text, size_t length)
+{
+    Scanner s;
+    s.p = text;
+    s.end = text + length;
+
+    //an event line takes about a dozen bytes
+    events.reserve(events.size() + length / 12);
+
+    int read = 0;
+    int type = 1;
+
+    while (s.p < s.end)
+    {
+        if (scanWord(s, "finish"))
+        {
+            //empty demonstrations are not kept
+            if ((int) events.size() > starts.back())
+            {
+                starts.push_back(events.size());
+                read++;
+            }
+
+            type = 1;
+            nextLine(s);
+            continue;
+        }
+
+        if (scanWord(s, "end"))
+            break;
+
+        int v[5];
+        int f = 0;
+
+        while (f < 5 && scanInt(s, v[f]))
+            f++;
+
+        nextLine(s);
+
+        //lines that are not events are skipped
+        if (f < 5)
+            continue;
+
+        EventUnion e;
+
+        e.action.deltaX = v[0];
+        e.action.deltaY = v[1];
+        e.action.deltaZ = v[2];
+        e.action.deltaangle = v[3];
+        e.action.grasp = v[4];
+
+        events.push_back(makeEventItem(e, type));
+        type = type == 1 ? 2 : 1;
+    }
+
+    //the unfinished tail
+    events.resize(starts.back());
+
+    return read;
+}
+
+int TrainingData::parseLog(const char *data, size_t length)
+{
+    if (!isDemoLog(data, length))
+        return -1;
+
+    const DemoLogHeader *header = (const DemoLogHeader *) data;
+
+    if (header->version != DEMOLOG_VERSION || header->recordSize != sizeof(DemoLogRecord))
+        return -1;
+
+    //a record cut short by a crash is ignored
+    size_t count = (length - sizeof(DemoLogHeader)) / sizeof(DemoLogRecord);
+    const DemoLogRecord *records = (const DemoLogRecord *) (data + sizeof(DemoLogHeader));
+
+    events.reserve(events.size() + count);
+
+    size_t demos = starts.size();
+    int read = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        int type = records[i].type;
+
+        //a corrupt record rejects the whole log, the demonstrations read so far included
+        if (type != 1 && type != 2 && type != DEMOLOG_FINISH)
+        {
+            fprintf(stderr, "demonstration log: record type %d at offset %zu\n", type, sizeof(DemoLogHeader) + i * sizeof(DemoLogRecord));
+
+            starts.resize(demos);
+            events.resize(starts.back());
+
+            return -1;
+        }
+
+        if (type == DEMOLOG_FINISH)
+        {
+            if ((int) events.size() > starts.back())
+            {
+                starts.push_back(events.size());
+                read++;
+            }
+
+            continue;
+        }
+
+        events.push_back(makeEventItem(records[i].event, type));
+    }
+
+    events.resize(starts.back());
+
+    return read;
+}
+
+int TrainingData::load(const char *path)
+{
+    MappedFile file;
+
+    if (!file.open(path, MAPPED_SEQUENTIAL))
+        return -1;
+
+    if (isDemoLog(file.data(), file.size()))
+        return parseLog(file.data(), file.size());
+
+    return parse(file.data(), file.size());
+}
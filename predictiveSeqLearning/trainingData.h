@@ -0,0 +1,47 @@
+#ifndef TRAININGDATA_H
+#define TRAININGDATA_H
+
+#include <stddef.h>
+#include <vector>
+#include "eventSeq.h"
+
+using namespace std;
+
+//demonstrations of trainingdata files, held in one contiguous event buffer.
+//a file has one event per line, " dx dy dz dangle grasp"; each demonstration alternates action and
+//observation lines starting with an action, "finish" ends a demonstration and "end" ends the file.
+//events after the last "finish" belong to no demonstration and are dropped, as hyptrain does.
+//binary demonstration logs (demoLog.h) hold the same demonstrations and are read the same way.
+
+class TrainingData
+{
+public:
+    TrainingData() { starts.push_back(0); }
+
+    void clear();
+
+    //appends the demonstrations in text[0, length), returns how many were read
+    int parse(const char *text, size_t length);
+
+    //appends the demonstrations of a binary log, header included; returns how many were read or -1
+    //if it is not a log of this version or holds a record that is neither an action (1), an observation (2)
+    //nor DEMOLOG_FINISH. the offset of such a record is reported on stderr and nothing is appended
+    int parseLog(const char *data, size_t length);
+
+    //maps the file and parses it as a binary log or as text, -1 if it can't be read
+    int load(const char *path);
+
+    //demonstrations held
+    int size() const { return (int) starts.size() - 1; }
+
+    //view of demonstration i, valid until the next parse
+    EventView demo(int i) const { return EventView(events.data() + starts[i], starts[i + 1] - starts[i]); }
+
+    int eventCount() const { return (int) events.size(); }
+
+private:
+    vector<EventItem> events;
+    vector<int> starts; //first event of every demonstration, then the number of events
+};
+
+#endif